@@ -0,0 +1,334 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Opt-in heap instrumentation for the containers in this repo
+// - compile with -DALLOC_TRACKING to turn it on; without it allocate() is
+//   plain operator new, the hooks are empty inline functions and
+//   ALLOC_SCOPE expands to nothing
+// - counts allocations, frees, bytes, reallocation copies and live/peak bytes
+//   per container kind and per tagged call site (ALLOC_SCOPE("tag"))
+// - when on, each block carries a small header with the allocating site, so a
+//   free is charged to the site that allocated it wherever it happens
+// - the flag must be the same in every translation unit of a program
+#ifdef ALLOC_TRACKING
+inline constexpr bool alloc_tracking_enabled = true;
+#else
+inline constexpr bool alloc_tracking_enabled = false;
+#endif
+
+enum class alloc_kind : uint32_t { vector, string, list, shared_ptr, other, count };
+
+inline const char* alloc_kind_name(alloc_kind k) {
+    static constexpr const char* names[] = {"vector", "string", "list", "shared_ptr", "other"};
+    return names[uint32_t(k)];
+}
+
+// Plain copy of one set of counters
+struct alloc_counters {
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t bytes_freed = 0;
+    uint64_t realloc_copies = 0;        // reallocations that moved existing elements
+    uint64_t realloc_copy_bytes = 0;    // bytes those reallocations moved
+    int64_t live_bytes = 0;
+    int64_t peak_live_bytes = 0;
+};
+
+// Point-in-time copy of every counter
+struct alloc_snapshot {
+    int64_t timestamp_ms = 0;                                   // system clock, ms since epoch
+    alloc_counters kinds[size_t(alloc_kind::count)];
+    std::vector<std::pair<std::string, alloc_counters>> sites;  // site 0 = "(untagged)"
+
+    const alloc_counters& operator[](alloc_kind k) const { return kinds[size_t(k)]; }
+
+    // One JSON object on a single line
+    std::string to_json() const {
+        std::string out = "{\"timestamp_ms\":" + std::to_string(timestamp_ms);
+        out += ",\"enabled\":";
+        out += alloc_tracking_enabled ? "true" : "false";
+        out += ",\"kinds\":{";
+        for (size_t k=0; k<size_t(alloc_kind::count); k++) {
+            if (k) out += ',';
+            append_entry(out, alloc_kind_name(alloc_kind(k)), kinds[k]);
+        }
+        out += "},\"sites\":{";
+        for (size_t i=0; i<sites.size(); i++) {
+            if (i) out += ',';
+            append_entry(out, sites[i].first, sites[i].second);
+        }
+        out += "}}";
+        return out;
+    }
+
+private:
+    static void append_entry(std::string& out, const std::string& name, const alloc_counters& c) {
+        out += '"';
+        for (char ch : name) {
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                // control characters are not allowed raw in a JSON string
+                static constexpr char hex[] = "0123456789abcdef";
+                out += "\\u00";
+                out += hex[(ch >> 4) & 0xf];
+                out += hex[ch & 0xf];
+                continue;
+            }
+            if (ch == '"' || ch == '\\') out += '\\';
+            out += ch;
+        }
+        out += "\":{\"allocs\":" + std::to_string(c.allocs)
+             + ",\"frees\":" + std::to_string(c.frees)
+             + ",\"bytes_allocated\":" + std::to_string(c.bytes_allocated)
+             + ",\"bytes_freed\":" + std::to_string(c.bytes_freed)
+             + ",\"realloc_copies\":" + std::to_string(c.realloc_copies)
+             + ",\"realloc_copy_bytes\":" + std::to_string(c.realloc_copy_bytes)
+             + ",\"live_bytes\":" + std::to_string(c.live_bytes)
+             + ",\"peak_live_bytes\":" + std::to_string(c.peak_live_bytes) + "}";
+    }
+};
+
+class alloc_tracker {
+public:
+    static constexpr uint32_t max_sites = 256;
+
+private:
+    struct counters {
+        std::atomic<uint64_t> allocs{0};
+        std::atomic<uint64_t> frees{0};
+        std::atomic<uint64_t> bytes_allocated{0};
+        std::atomic<uint64_t> bytes_freed{0};
+        std::atomic<uint64_t> realloc_copies{0};
+        std::atomic<uint64_t> realloc_copy_bytes{0};
+        std::atomic<int64_t> live_bytes{0};
+        std::atomic<int64_t> peak_live_bytes{0};
+
+        void on_alloc(size_t n) noexcept {
+            allocs.fetch_add(1, std::memory_order_relaxed);
+            bytes_allocated.fetch_add(n, std::memory_order_relaxed);
+            int64_t live = live_bytes.fetch_add(int64_t(n), std::memory_order_relaxed) + int64_t(n);
+            int64_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+            while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        }
+
+        void on_free(size_t n) noexcept {
+            frees.fetch_add(1, std::memory_order_relaxed);
+            bytes_freed.fetch_add(n, std::memory_order_relaxed);
+            live_bytes.fetch_sub(int64_t(n), std::memory_order_relaxed);
+        }
+
+        void on_realloc_copy(size_t n) noexcept {
+            realloc_copies.fetch_add(1, std::memory_order_relaxed);
+            realloc_copy_bytes.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        alloc_counters copy() const noexcept {
+            return {allocs.load(std::memory_order_relaxed), frees.load(std::memory_order_relaxed),
+                    bytes_allocated.load(std::memory_order_relaxed), bytes_freed.load(std::memory_order_relaxed),
+                    realloc_copies.load(std::memory_order_relaxed), realloc_copy_bytes.load(std::memory_order_relaxed),
+                    live_bytes.load(std::memory_order_relaxed), peak_live_bytes.load(std::memory_order_relaxed)};
+        }
+    };
+
+    struct state {
+        counters kinds[size_t(alloc_kind::count)];
+        counters sites[max_sites];
+        const char* site_tags[max_sites] = {"(untagged)"};
+        std::atomic<uint32_t> site_count{1};
+        std::mutex register_mtx;
+    };
+
+    // never destroyed: containers may be freed during static destruction
+    static state& global() {
+        static state* s = new state();
+        return *s;
+    }
+
+    inline static thread_local uint32_t current = 0;
+
+    // header in front of each tracked block: the site that allocated it
+    static constexpr size_t header_size(size_t align) noexcept {
+        return align > alignof(std::max_align_t) ? align : alignof(std::max_align_t);
+    }
+
+    friend class alloc_scope;
+
+public:
+    // Register a call-site tag once and get its index; unknown tags beyond
+    // max_sites are charged to site 0
+    static uint32_t site(const char* tag) {
+        state& s = global();
+        std::lock_guard<std::mutex> lock(s.register_mtx);
+        uint32_t n = s.site_count.load(std::memory_order_relaxed);
+        for (uint32_t i=1; i<n; i++) {
+            if (std::strcmp(s.site_tags[i], tag) == 0) return i;
+        }
+        if (n == max_sites) return 0;
+        s.site_tags[n] = tag;
+        s.site_count.store(n + 1, std::memory_order_release);
+        return n;
+    }
+
+    // Allocate bytes for a container of kind k
+    static void* allocate(alloc_kind k, size_t bytes, size_t align = alignof(std::max_align_t)) {
+        if constexpr (!alloc_tracking_enabled) {
+            (void)k;
+            if (align > alignof(std::max_align_t)) return ::operator new(bytes, std::align_val_t(align));
+            return ::operator new(bytes);
+        } else {
+            size_t header = header_size(align);
+            unsigned char* raw = static_cast<unsigned char*>(
+                align > alignof(std::max_align_t) ? ::operator new(bytes + header, std::align_val_t(align))
+                                                  : ::operator new(bytes + header));
+            uint32_t site_id = current;
+            std::memcpy(raw, &site_id, sizeof(site_id));
+
+            state& s = global();
+            s.kinds[size_t(k)].on_alloc(bytes);
+            s.sites[site_id].on_alloc(bytes);
+            return raw + header;
+        }
+    }
+
+    // Free a block from allocate(); bytes and align must match the allocation
+    static void deallocate(alloc_kind k, void* p, size_t bytes, size_t align = alignof(std::max_align_t)) noexcept {
+        if constexpr (!alloc_tracking_enabled) {
+            (void)k;
+            (void)bytes;
+            if (align > alignof(std::max_align_t)) ::operator delete(p, std::align_val_t(align));
+            else ::operator delete(p);
+        } else {
+            if (!p) return;
+            size_t header = header_size(align);
+            unsigned char* raw = static_cast<unsigned char*>(p) - header;
+            uint32_t site_id;
+            std::memcpy(&site_id, raw, sizeof(site_id));
+
+            state& s = global();
+            s.kinds[size_t(k)].on_free(bytes);
+            s.sites[site_id].on_free(bytes);
+            if (align > alignof(std::max_align_t)) ::operator delete(raw, std::align_val_t(align));
+            else ::operator delete(raw);
+        }
+    }
+
+    // A reallocation moved bytes of existing elements to a new block
+    static void on_realloc_copy(alloc_kind k, size_t bytes) noexcept {
+        if constexpr (alloc_tracking_enabled) {
+            state& s = global();
+            s.kinds[size_t(k)].on_realloc_copy(bytes);
+            s.sites[current].on_realloc_copy(bytes);
+        } else {
+            (void)k;
+            (void)bytes;
+        }
+    }
+
+    // Observers - all zero when tracking is off
+    static alloc_snapshot snapshot() {
+        alloc_snapshot snap;
+        snap.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        if constexpr (alloc_tracking_enabled) {
+            state& s = global();
+            for (size_t k=0; k<size_t(alloc_kind::count); k++) snap.kinds[k] = s.kinds[k].copy();
+            uint32_t n = s.site_count.load(std::memory_order_acquire);
+            snap.sites.reserve(n);
+            for (uint32_t i=0; i<n; i++) snap.sites.emplace_back(s.site_tags[i], s.sites[i].copy());
+        }
+        return snap;
+    }
+};
+
+// RAII call-site tag - allocations on this thread inside the scope are
+// charged to the site; scopes nest and restore the outer tag on exit
+class alloc_scope {
+private:
+    uint32_t previous;
+
+public:
+    explicit alloc_scope(uint32_t site) noexcept : previous(alloc_tracker::current) {
+        alloc_tracker::current = site;
+    }
+    ~alloc_scope() { alloc_tracker::current = previous; }
+
+    alloc_scope(const alloc_scope&) = delete;
+    alloc_scope& operator=(const alloc_scope&) = delete;
+};
+
+#define ALLOC_TRACKER_CONCAT_(a, b) a##b
+#define ALLOC_TRACKER_CONCAT(a, b) ALLOC_TRACKER_CONCAT_(a, b)
+
+// ALLOC_SCOPE("tag"); - tag registered once per call site
+#ifdef ALLOC_TRACKING
+#define ALLOC_SCOPE(tag)                                                              \
+    static const uint32_t ALLOC_TRACKER_CONCAT(alloc_site_, __LINE__) = alloc_tracker::site(tag); \
+    alloc_scope ALLOC_TRACKER_CONCAT(alloc_scope_, __LINE__)(ALLOC_TRACKER_CONCAT(alloc_site_, __LINE__))
+#else
+#define ALLOC_SCOPE(tag) static_assert(true)
+#endif
+
+// Base giving a node/block type class-level operator new/delete that go
+// through alloc_tracker (list nodes, shared_ptr control blocks)
+template<alloc_kind Kind>
+struct tracked_new {
+    static void* operator new(size_t n) { return alloc_tracker::allocate(Kind, n); }
+    static void* operator new(size_t n, std::align_val_t al) { return alloc_tracker::allocate(Kind, n, size_t(al)); }
+    static void operator delete(void* p, size_t n) noexcept { alloc_tracker::deallocate(Kind, p, n); }
+    static void operator delete(void* p, size_t n, std::align_val_t al) noexcept {
+        alloc_tracker::deallocate(Kind, p, n, size_t(al));
+    }
+};
+
+// Periodic dump - a background thread appends one snapshot JSON line to out
+// every interval, plus a final line when the dumper is destroyed
+class alloc_dumper {
+private:
+    std::FILE* out;
+    std::chrono::milliseconds interval;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::thread thread;
+
+    void write() {
+        std::string line = alloc_tracker::snapshot().to_json();
+        line += '\n';
+        std::fwrite(line.data(), 1, line.size(), out);
+        std::fflush(out);
+    }
+
+public:
+    alloc_dumper(std::FILE* output, std::chrono::milliseconds every)
+        : out(output), interval(every) {
+        thread = std::thread([this] {
+            std::unique_lock<std::mutex> lock(mtx);
+            while (!cv.wait_for(lock, interval, [this] { return stopping; })) write();
+        });
+    }
+
+    ~alloc_dumper() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_one();
+        thread.join();
+        write();
+    }
+
+    alloc_dumper(const alloc_dumper&) = delete;
+    alloc_dumper& operator=(const alloc_dumper&) = delete;
+};
@@ -0,0 +1,170 @@
+#define ALLOC_TRACKING
+#include "gtest/gtest.h"
+#include "alloc_tracker.hpp"
+#include "../vector/vector.hpp"
+#include "../string/string.hpp"
+#include "../list/list.hpp"
+#include "../shared_ptr/shared_ptr.hpp"
+#include <thread>
+
+// counters of kind k accumulated since `before`
+static alloc_counters since(const alloc_snapshot& before, alloc_kind k) {
+    alloc_counters now = alloc_tracker::snapshot()[k];
+    const alloc_counters& b = before[k];
+    return {now.allocs - b.allocs, now.frees - b.frees,
+            now.bytes_allocated - b.bytes_allocated, now.bytes_freed - b.bytes_freed,
+            now.realloc_copies - b.realloc_copies, now.realloc_copy_bytes - b.realloc_copy_bytes,
+            now.live_bytes - b.live_bytes, now.peak_live_bytes};
+}
+
+static const alloc_counters* find_site(const alloc_snapshot& snap, const char* tag) {
+    for (auto& [name, c] : snap.sites) {
+        if (name == tag) return &c;
+    }
+    return nullptr;
+}
+
+TEST(AllocTrackerTest, VectorGrowth) {
+    auto before = alloc_tracker::snapshot();
+    {
+        vector<int> v;
+        for (int i=0; i<5; i++) v.push_back(i);     // capacity 1, 2, 4, 8
+
+        auto c = since(before, alloc_kind::vector);
+        EXPECT_EQ(c.allocs, 4);
+        EXPECT_EQ(c.frees, 3);
+        EXPECT_EQ(c.bytes_allocated, (1 + 2 + 4 + 8) * sizeof(int));
+        EXPECT_EQ(c.live_bytes, 8 * sizeof(int));
+        EXPECT_EQ(c.realloc_copies, 3);
+        EXPECT_EQ(c.realloc_copy_bytes, (1 + 2 + 4) * sizeof(int));
+    }
+    auto c = since(before, alloc_kind::vector);
+    EXPECT_EQ(c.frees, 4);
+    EXPECT_EQ(c.live_bytes, 0);
+}
+
+TEST(AllocTrackerTest, StringAndList) {
+    auto before = alloc_tracker::snapshot();
+    {
+        string s("abc");
+        s.push_back('d');                           // reallocate, copies 3 chars
+        list<int> l;
+        for (int i=0; i<10; i++) l.push_back(i);
+
+        auto sc = since(before, alloc_kind::string);
+        EXPECT_EQ(sc.allocs, 2);
+        EXPECT_EQ(sc.realloc_copy_bytes, 3);
+        EXPECT_EQ(since(before, alloc_kind::list).allocs, 10);
+    }
+    EXPECT_EQ(since(before, alloc_kind::string).live_bytes, 0);
+    auto lc = since(before, alloc_kind::list);
+    EXPECT_EQ(lc.frees, 10);
+    EXPECT_EQ(lc.live_bytes, 0);
+}
+
+TEST(AllocTrackerTest, SharedPtrControlBlocks) {
+    auto before = alloc_tracker::snapshot();
+    {
+        auto a = make_shared<int>(1);               // object fused into the block
+        shared_ptr<int> b(new int(2));              // separate block, object not tracked
+        auto c = a;                                 // copies don't allocate
+        EXPECT_EQ(since(before, alloc_kind::shared_ptr).allocs, 2);
+    }
+    auto c = since(before, alloc_kind::shared_ptr);
+    EXPECT_EQ(c.frees, 2);
+    EXPECT_EQ(c.live_bytes, 0);
+}
+
+TEST(AllocTrackerTest, TaggedSitesKeepAllocatingSite) {
+    vector<int>* escaped;
+    {
+        ALLOC_SCOPE("test.outer");
+        escaped = new vector<int>(16);
+        {
+            ALLOC_SCOPE("test.inner");
+            vector<int> tmp(4);
+        }
+        vector<int> more(8);                        // back to the outer tag
+    }
+
+    auto snap = alloc_tracker::snapshot();
+    const alloc_counters* outer = find_site(snap, "test.outer");
+    const alloc_counters* inner = find_site(snap, "test.inner");
+    ASSERT_NE(outer, nullptr);
+    ASSERT_NE(inner, nullptr);
+    EXPECT_EQ(outer->allocs, 2);
+    EXPECT_EQ(outer->live_bytes, 16 * sizeof(int));
+    EXPECT_EQ(inner->allocs, 1);
+    EXPECT_EQ(inner->live_bytes, 0);
+
+    delete escaped;                                 // freed untagged, charged to its site
+    EXPECT_EQ(find_site(alloc_tracker::snapshot(), "test.outer")->live_bytes, 0);
+    EXPECT_EQ(find_site(alloc_tracker::snapshot(), "test.outer")->peak_live_bytes, (16 + 8) * sizeof(int));
+}
+
+TEST(AllocTrackerTest, ConcurrentSites) {
+    auto before = alloc_tracker::snapshot();
+    std::vector<std::thread> threads;
+    for (int t=0; t<4; t++) {
+        threads.emplace_back([] {
+            ALLOC_SCOPE("test.worker");
+            for (int i=0; i<1000; i++) {
+                list<int> l;
+                l.push_back(i);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    auto c = since(before, alloc_kind::list);
+    EXPECT_EQ(c.allocs, 4000);
+    EXPECT_EQ(c.frees, 4000);
+    auto snap = alloc_tracker::snapshot();
+    const alloc_counters* site = find_site(snap, "test.worker");
+    ASSERT_NE(site, nullptr);
+    EXPECT_EQ(site->allocs, 4000);
+    EXPECT_EQ(site->live_bytes, 0);
+}
+
+TEST(AllocTrackerTest, JsonSnapshot) {
+    std::string json = alloc_tracker::snapshot().to_json();
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_EQ(json.find('\n'), std::string::npos);
+    EXPECT_NE(json.find("\"enabled\":true"), std::string::npos);
+    EXPECT_NE(json.find("\"vector\":{\"allocs\":"), std::string::npos);
+    EXPECT_NE(json.find("\"(untagged)\""), std::string::npos);
+
+    // quotes, backslashes and control characters in a tag are escaped
+    {
+        ALLOC_SCOPE("test.\"tab\\\t\x01");
+        vector<int> v;
+        v.push_back(1);
+    }
+    json = alloc_tracker::snapshot().to_json();
+    EXPECT_NE(json.find("\"test.\\\"tab\\\\\\u0009\\u0001\""), std::string::npos);
+    EXPECT_EQ(json.find('\t'), std::string::npos);
+}
+
+TEST(AllocTrackerTest, PeriodicDump) {
+    std::FILE* f = std::tmpfile();
+    ASSERT_NE(f, nullptr);
+    {
+        alloc_dumper dumper(f, std::chrono::milliseconds(5));
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+    std::rewind(f);
+    int lines = 0;
+    char buf[1 << 16];
+    while (std::fgets(buf, sizeof(buf), f)) {
+        EXPECT_EQ(buf[0], '{');
+        lines++;
+    }
+    std::fclose(f);
+    EXPECT_GE(lines, 2);        // at least one periodic line + the final one
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,51 @@
+// Set operations and count: dynamic_bitset vs vector<bool> (a byte per flag)
+// g++ -std=c++20 -O2 -march=native bench.cpp -o bench && ./bench
+#include "dynamic_bitset.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+template<typename F>
+double time_ms(int rounds, F f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r=0; r<rounds; r++) f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+int main() {
+    const size_t n = size_t(1) << 27;      // 128M flags
+    const int rounds = 10;
+    std::mt19937_64 rng(1);
+
+    vector<bool> x(n), y(n);
+    dynamic_bitset a(n), b(n);
+    for (size_t i=0; i<n; i++) {
+        bool u = rng() & 1, v = rng() & 1;
+        x.push_back(u);
+        y.push_back(v);
+        a.set(i, u);
+        b.set(i, v);
+    }
+    std::printf("memory: vector<bool> %zu MB, dynamic_bitset %zu MB\n",
+        n / (1 << 20), a.num_words() * 8 / (1 << 20));
+
+    double bytes_and = time_ms(rounds, [&] { for (size_t i=0; i<n; i++) x[i] = x[i] & y[i]; });
+    double bits_and = time_ms(rounds, [&] { a &= b; });
+    // bitset AND reads two and writes one bitmap
+    double gbps = 3.0 * double(a.num_words() * 8) / (bits_and * 1e6);
+
+    size_t c1 = 0, c2 = 0;
+    double bytes_count = time_ms(rounds, [&] { c1 = 0; for (size_t i=0; i<n; i++) c1 += x[i]; });
+    double bits_count = time_ms(rounds, [&] { c2 = a.count(); });
+
+    std::printf("AND:   vector<bool> %8.2f ms  dynamic_bitset %8.2f ms (%.1f GB/s)\n", bytes_and, bits_and, gbps);
+    std::printf("count: vector<bool> %8.2f ms  dynamic_bitset %8.2f ms  (%zu == %zu)\n",
+        bytes_count, bits_count, c1, c2);
+
+    rank_select rs(a);
+    const size_t selects = 1'000'000;
+    size_t sum = 0;
+    double select_ms = time_ms(1, [&] { for (size_t k=0; k<selects; k++) sum += rs.select((k * 7919) % c2); });
+    double select_ns = select_ms * 1e6 / double(selects);
+    std::printf("select: %.1f ns/op (checksum %zu)\n", select_ns, sum);
+}
@@ -0,0 +1,281 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+#include "../vector/vector.hpp"
+
+// Packed bitset on vector<uint64_t> - one bit per flag instead of a byte
+// - bits past size() in the last word are always zero, so count(), any()
+//   and the set operations never need to mask
+// - &=, |=, ^=, and_not run 4 words per AVX2 instruction when compiled with
+//   -mavx2, one word per instruction otherwise; count() uses the AVX2 nibble
+//   lookup popcount (Mula) or popcnt
+// - find_first/find_next/for_each_set skip zero words and use ctz (tzcnt)
+// - rank/select live in rank_select, an index built over a finished bitset
+class dynamic_bitset {
+private:
+    vector<uint64_t> words;
+    size_t nbits;
+
+    static constexpr size_t word_count(size_t bits) { return (bits + 63) / 64; }
+
+    uint64_t* data() { return words.getSize() ? &words[0] : nullptr; }
+    const uint64_t* data() const { return words.getSize() ? &words[0] : nullptr; }
+
+    // zero the bits past nbits in the last word
+    void trim() {
+        if (nbits % 64) words[words.getSize() - 1] &= (uint64_t(1) << (nbits % 64)) - 1;
+    }
+
+    void check_same_size(const dynamic_bitset& other) const {
+        if (nbits != other.nbits) throw std::invalid_argument("dynamic_bitset: size mismatch");
+    }
+
+    // word-wise operations: scalar form + AVX2 form (4 words)
+    struct and_op {
+        static uint64_t word(uint64_t x, uint64_t y) { return x & y; }
+#if defined(__AVX2__)
+        static __m256i vec(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+#endif
+    };
+    struct or_op {
+        static uint64_t word(uint64_t x, uint64_t y) { return x | y; }
+#if defined(__AVX2__)
+        static __m256i vec(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+#endif
+    };
+    struct xor_op {
+        static uint64_t word(uint64_t x, uint64_t y) { return x ^ y; }
+#if defined(__AVX2__)
+        static __m256i vec(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+#endif
+    };
+    struct andnot_op {
+        static uint64_t word(uint64_t x, uint64_t y) { return x & ~y; }
+#if defined(__AVX2__)
+        static __m256i vec(__m256i x, __m256i y) { return _mm256_andnot_si256(y, x); }
+#endif
+    };
+
+    // this[i] = Op(this[i], other[i]) over all words
+    template<typename Op>
+    void combine(const dynamic_bitset& other) {
+        check_same_size(other);
+        uint64_t* a = data();
+        const uint64_t* b = other.data();
+        size_t n = words.getSize();
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= n; i += 4) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), Op::vec(x, y));
+        }
+#endif
+        for (; i < n; i++) a[i] = Op::word(a[i], b[i]);
+    }
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Constructor - n bits, all clear or all set
+    explicit dynamic_bitset(size_t n = 0, bool value = false)
+        : words(word_count(n)), nbits(n) {
+        for (size_t i=0; i<word_count(n); i++) words.push_back(value ? ~uint64_t(0) : 0);
+        trim();
+    }
+
+    // Capacity
+    size_t size() const { return nbits; }
+    bool empty() const { return nbits == 0; }
+    size_t num_words() const { return words.getSize(); }
+    const uint64_t* word_data() const { return data(); }
+
+    // Element access
+    bool test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+    bool operator[](size_t i) const { return test(i); }
+
+    // Modifiers
+    void set(size_t i) { words[i / 64] |= uint64_t(1) << (i % 64); }
+    void set(size_t i, bool value) {
+        uint64_t mask = uint64_t(1) << (i % 64);
+        words[i / 64] = (words[i / 64] & ~mask) | ((uint64_t(0) - uint64_t(value)) & mask);
+    }
+    void reset(size_t i) { words[i / 64] &= ~(uint64_t(1) << (i % 64)); }
+    void flip(size_t i) { words[i / 64] ^= uint64_t(1) << (i % 64); }
+
+    void set_all() {
+        for (size_t i=0; i<words.getSize(); i++) words[i] = ~uint64_t(0);
+        trim();
+    }
+    void reset_all() {
+        for (size_t i=0; i<words.getSize(); i++) words[i] = 0;
+    }
+    void flip_all() {
+        for (size_t i=0; i<words.getSize(); i++) words[i] = ~words[i];
+        trim();
+    }
+
+    void push_back(bool value) {
+        if (nbits % 64 == 0) words.push_back(0);
+        nbits++;
+        set(nbits - 1, value);
+    }
+
+    // Grow with clear bits or shrink
+    void resize(size_t n) {
+        while (words.getSize() < word_count(n)) words.push_back(0);
+        while (words.getSize() > word_count(n)) words.pop();
+        nbits = n;
+        trim();
+    }
+
+    // Set operations - both operands must have the same size
+    dynamic_bitset& operator&=(const dynamic_bitset& other) { combine<and_op>(other); return *this; }
+    dynamic_bitset& operator|=(const dynamic_bitset& other) { combine<or_op>(other); return *this; }
+    dynamic_bitset& operator^=(const dynamic_bitset& other) { combine<xor_op>(other); return *this; }
+    // this &= ~other
+    dynamic_bitset& and_not(const dynamic_bitset& other) { combine<andnot_op>(other); return *this; }
+
+    friend dynamic_bitset operator&(dynamic_bitset a, const dynamic_bitset& b) { return std::move(a &= b); }
+    friend dynamic_bitset operator|(dynamic_bitset a, const dynamic_bitset& b) { return std::move(a |= b); }
+    friend dynamic_bitset operator^(dynamic_bitset a, const dynamic_bitset& b) { return std::move(a ^= b); }
+
+    bool operator==(const dynamic_bitset& other) const {
+        if (nbits != other.nbits) return false;
+        for (size_t i=0; i<words.getSize(); i++) {
+            if (words[i] != other.words[i]) return false;
+        }
+        return true;
+    }
+
+    // Population count of n words
+    static size_t popcount(const uint64_t* w, size_t n) {
+        size_t i = 0;
+        uint64_t total = 0;
+#if defined(__AVX2__)
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low = _mm256_set1_epi8(0x0F);
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 4 <= n; i += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+            __m256i lo = _mm256_and_si256(v, low);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+            __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+        }
+        total += uint64_t(_mm256_extract_epi64(acc, 0)) + uint64_t(_mm256_extract_epi64(acc, 1))
+               + uint64_t(_mm256_extract_epi64(acc, 2)) + uint64_t(_mm256_extract_epi64(acc, 3));
+#endif
+        for (; i < n; i++) total += uint64_t(__builtin_popcountll(w[i]));
+        return size_t(total);
+    }
+
+    // Observers
+    size_t count() const { return popcount(data(), words.getSize()); }
+    bool any() const {
+        for (size_t i=0; i<words.getSize(); i++) {
+            if (words[i]) return true;
+        }
+        return false;
+    }
+    bool none() const { return !any(); }
+    bool all() const { return count() == nbits; }
+
+    // Iteration over set bits
+    size_t find_first() const { return find_from(0); }
+    size_t find_next(size_t pos) const { return pos + 1 >= nbits ? npos : find_from(pos + 1); }
+
+    // first set bit at or after pos
+    size_t find_from(size_t pos) const {
+        if (pos >= nbits) return npos;
+        size_t wi = pos / 64;
+        uint64_t w = words[wi] & (~uint64_t(0) << (pos % 64));
+        while (!w) {
+            if (++wi == words.getSize()) return npos;
+            w = words[wi];
+        }
+        return wi * 64 + size_t(__builtin_ctzll(w));
+    }
+
+    // f(index) for every set bit, in order
+    template<typename F>
+    void for_each_set(F f) const {
+        for (size_t wi=0; wi<words.getSize(); wi++) {
+            for (uint64_t w = words[wi]; w; w &= w - 1) f(wi * 64 + size_t(__builtin_ctzll(w)));
+        }
+    }
+};
+
+// Rank/select index over a bitset that is no longer being modified
+// - one cumulative count per 512-bit block (8 words): 12.5% extra space
+// - rank(i): block count + popcount of at most 7 words + a masked word
+// - select(k): binary search over block counts, then a word scan, then
+//   pdep + tzcnt (BMI2) or clear-lowest-bit steps inside the word
+class rank_select {
+private:
+    static constexpr size_t block_words = 8;
+
+    const dynamic_bitset* bits;
+    vector<uint64_t> block_rank;        // set bits before each block, plus the total
+
+    static size_t select_in_word(uint64_t w, size_t k) {
+#if defined(__BMI2__)
+        return size_t(__builtin_ctzll(_pdep_u64(uint64_t(1) << k, w)));
+#else
+        for (; k; k--) w &= w - 1;
+        return size_t(__builtin_ctzll(w));
+#endif
+    }
+
+public:
+    explicit rank_select(const dynamic_bitset& b) : bits(&b), block_rank(b.num_words() / block_words + 2) {
+        const uint64_t* w = b.word_data();
+        size_t n = b.num_words();
+        uint64_t total = 0;
+        for (size_t start=0; start<n; start+=block_words) {
+            block_rank.push_back(total);
+            size_t len = n - start < block_words ? n - start : block_words;
+            total += dynamic_bitset::popcount(w + start, len);
+        }
+        block_rank.push_back(total);
+    }
+
+    // set bits in [0, i)
+    size_t rank(size_t i) const {
+        if (i >= bits->size()) return size_t(block_rank[block_rank.getSize() - 1]);
+        const uint64_t* w = bits->word_data();
+        size_t wi = i / 64;
+        size_t block = wi / block_words;
+        size_t r = size_t(block_rank[block]);
+        r += dynamic_bitset::popcount(w + block * block_words, wi - block * block_words);
+        if (i % 64) r += size_t(__builtin_popcountll(w[wi] & ((uint64_t(1) << (i % 64)) - 1)));
+        return r;
+    }
+
+    // position of the k-th set bit (0-based), npos if k >= count()
+    size_t select(size_t k) const {
+        size_t blocks = block_rank.getSize() - 1;
+        if (k >= block_rank[blocks]) return dynamic_bitset::npos;
+
+        // last block whose starting rank <= k
+        size_t lo = 0, hi = blocks;
+        while (hi - lo > 1) {
+            size_t mid = (lo + hi) / 2;
+            if (block_rank[mid] <= k) lo = mid;
+            else hi = mid;
+        }
+        const uint64_t* w = bits->word_data();
+        size_t remaining = k - size_t(block_rank[lo]);
+        for (size_t wi = lo * block_words; ; wi++) {
+            size_t c = size_t(__builtin_popcountll(w[wi]));
+            if (remaining < c) return wi * 64 + select_in_word(w[wi], remaining);
+            remaining -= c;
+        }
+    }
+};
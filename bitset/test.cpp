@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+#include "dynamic_bitset.hpp"
+#include <random>
+#include <vector>
+
+static std::vector<bool> random_bits(size_t n, unsigned seed, int one_in = 3) {
+    std::mt19937 rng(seed);
+    std::vector<bool> v(n);
+    for (size_t i=0; i<n; i++) v[i] = rng() % one_in == 0;
+    return v;
+}
+
+static dynamic_bitset from(const std::vector<bool>& v) {
+    dynamic_bitset b(v.size());
+    for (size_t i=0; i<v.size(); i++) b.set(i, v[i]);
+    return b;
+}
+
+TEST(DynamicBitsetTest, SetTestAndPacking) {
+    dynamic_bitset b(1000);
+    EXPECT_EQ(b.num_words(), 16);           // 1000 flags in 128 bytes
+    EXPECT_TRUE(b.none());
+    b.set(0);
+    b.set(999);
+    b.set(500, true);
+    b.flip(501);
+    b.reset(0);
+    EXPECT_FALSE(b.test(0));
+    EXPECT_TRUE(b[999] && b[500] && b[501]);
+    EXPECT_EQ(b.count(), 3);
+
+    dynamic_bitset full(130, true);
+    EXPECT_EQ(full.count(), 130);           // tail bits stay clear
+    EXPECT_TRUE(full.all());
+    full.flip_all();
+    EXPECT_TRUE(full.none());
+}
+
+TEST(DynamicBitsetTest, SetOperationsMatchReference) {
+    for (size_t n : {0, 1, 63, 64, 65, 255, 256, 257, 5000}) {
+        auto x = random_bits(n, 1), y = random_bits(n, 2);
+        dynamic_bitset a = from(x), b = from(y);
+
+        dynamic_bitset and_ = a & b, or_ = a | b, xor_ = a ^ b, andnot = a;
+        andnot.and_not(b);
+        size_t expected_count = 0;
+        for (size_t i=0; i<n; i++) {
+            ASSERT_EQ(and_[i], x[i] && y[i]);
+            ASSERT_EQ(or_[i], x[i] || y[i]);
+            ASSERT_EQ(xor_[i], x[i] != y[i]);
+            ASSERT_EQ(andnot[i], x[i] && !y[i]);
+            expected_count += x[i];
+        }
+        EXPECT_EQ(a.count(), expected_count) << n;
+    }
+    dynamic_bitset small(10), big(11);
+    EXPECT_THROW(small &= big, std::invalid_argument);
+}
+
+TEST(DynamicBitsetTest, FindFirstAndNext) {
+    auto x = random_bits(3000, 3, 50);
+    dynamic_bitset b = from(x);
+
+    std::vector<size_t> expected;
+    for (size_t i=0; i<x.size(); i++) {
+        if (x[i]) expected.push_back(i);
+    }
+    std::vector<size_t> walked;
+    for (size_t i = b.find_first(); i != b.npos; i = b.find_next(i)) walked.push_back(i);
+    EXPECT_EQ(walked, expected);
+
+    std::vector<size_t> visited;
+    b.for_each_set([&](size_t i) { visited.push_back(i); });
+    EXPECT_EQ(visited, expected);
+
+    EXPECT_EQ(dynamic_bitset(100).find_first(), dynamic_bitset::npos);
+}
+
+TEST(DynamicBitsetTest, PushBackAndResize) {
+    dynamic_bitset b;
+    for (int i=0; i<100; i++) b.push_back(i % 3 == 0);
+    EXPECT_EQ(b.size(), 100);
+    EXPECT_EQ(b.count(), 34);
+
+    b.resize(10);
+    EXPECT_EQ(b.count(), 4);                // 0, 3, 6, 9
+    b.resize(200);
+    EXPECT_EQ(b.count(), 4);                // regrown bits are clear
+    EXPECT_EQ(b.num_words(), 4);
+}
+
+TEST(RankSelectTest, MatchesScan) {
+    for (size_t n : {0, 1, 64, 511, 512, 513, 10000}) {
+        auto x = random_bits(n, 4, 7);
+        dynamic_bitset b = from(x);
+        rank_select rs(b);
+
+        size_t ones = 0;
+        for (size_t i=0; i<n; i++) {
+            ASSERT_EQ(rs.rank(i), ones) << i;
+            if (x[i]) {
+                ASSERT_EQ(rs.select(ones), i) << ones;
+                ones++;
+            }
+        }
+        EXPECT_EQ(rs.rank(n), ones);
+        EXPECT_EQ(rs.select(ones), dynamic_bitset::npos);
+    }
+}
+
+TEST(RankSelectTest, SparseBlocks) {
+    dynamic_bitset b(100000);
+    b.set(5);
+    b.set(70000);                            // many empty blocks between
+    rank_select rs(b);
+    EXPECT_EQ(rs.select(0), 5);
+    EXPECT_EQ(rs.select(1), 70000);
+    EXPECT_EQ(rs.rank(70000), 1);
+    EXPECT_EQ(rs.rank(70001), 2);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,65 @@
+// Queue workloads: deque (ring buffer) vs list vs std::deque
+// - steady: push_back + pop_front with the queue held at a fixed depth
+// - burst: fill to depth, then drain, repeated
+// g++ -std=c++20 -O2 bench.cpp -o bench && ./bench
+#include "deque.hpp"
+#include "../list/list.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+
+template<typename F>
+double ns_per_op(size_t ops, F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / double(ops);
+}
+
+template<typename Q>
+double steady(size_t depth, size_t ops) {
+    Q q;
+    for (size_t i=0; i<depth; i++) q.push_back(i);
+    uint64_t sum = 0;
+    double ns = ns_per_op(ops, [&] {
+        for (size_t i=0; i<ops; i++) {
+            q.push_back(i);
+            sum += q.front();
+            q.pop_front();
+        }
+    });
+    if (sum == 42) std::puts("");
+    return ns;
+}
+
+template<typename Q>
+double burst(size_t depth, size_t ops) {
+    Q q;
+    uint64_t sum = 0;
+    double ns = ns_per_op(ops, [&] {
+        for (size_t done=0; done<ops; done+=depth) {
+            for (size_t i=0; i<depth; i++) q.push_back(i);
+            for (size_t i=0; i<depth; i++) {
+                sum += q.front();
+                q.pop_front();
+            }
+        }
+    });
+    if (sum == 42) std::puts("");
+    return ns;
+}
+
+int main() {
+    const size_t ops = 10'000'000;
+    std::printf("%8s %8s %10s %10s %10s   (ns per push+pop)\n", "workload", "depth", "deque", "list", "std::deque");
+    for (size_t depth : {16, 1024, 65536, 1 << 20}) {
+        std::printf("%8s %8zu %10.2f %10.2f %10.2f\n", "steady", depth,
+            steady<deque<uint64_t>>(depth, ops), steady<list<uint64_t>>(depth, ops),
+            steady<std::deque<uint64_t>>(depth, ops));
+    }
+    for (size_t depth : {16, 1024, 65536, 1 << 20}) {
+        std::printf("%8s %8zu %10.2f %10.2f %10.2f\n", "burst", depth,
+            burst<deque<uint64_t>>(depth, ops), burst<list<uint64_t>>(depth, ops),
+            burst<std::deque<uint64_t>>(depth, ops));
+    }
+}
@@ -0,0 +1,284 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "../alloc_tracker/alloc_tracker.hpp"
+
+// Growable ring buffer - O(1) push/pop at both ends, O(1) random access
+// - capacity is always a power of two, so a logical index maps to a slot
+//   with one add and one mask instead of a modulo
+// - one contiguous allocation: no per-element node like list, and no
+//   pop-front shifting like vector
+// - the contents are at most two contiguous runs (head..end of buffer, then
+//   start of buffer..tail), exposed by spans() for bulk memcpy / writev
+// - growth unwraps the ring into a buffer twice the size; trivially copyable
+//   T is relocated with memcpy (same fast path as vector)
+template<typename T>
+class deque {
+private:
+    T* buf;
+    size_t head;        // slot of element 0
+    size_t count;
+    size_t cap;         // 0 or a power of two
+
+    static T* allocate(size_t n) {
+        return static_cast<T*>(alloc_tracker::allocate(alloc_kind::other, n*sizeof(T), alignof(T)));
+    }
+    static void deallocate(T* p, size_t n) noexcept {
+        alloc_tracker::deallocate(alloc_kind::other, p, n*sizeof(T), alignof(T));
+    }
+
+    size_t mask() const { return cap - 1; }
+    size_t slot(size_t i) const { return (head + i) & mask(); }
+
+    static size_t round_up(size_t n) {
+        size_t c = 1;
+        while (c < n) c *= 2;
+        return c;
+    }
+
+    // move [src, src+n) into raw dst, destroying the source
+    static void relocate(T* dst, T* src, size_t n) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (n) std::memcpy(static_cast<void*>(dst), src, n*sizeof(T));
+        } else {
+            for (size_t i=0; i<n; i++) {
+                new (dst+i) T(std::move(src[i]));
+                src[i].~T();
+            }
+        }
+    }
+
+    // move the contents to a buffer of new_cap slots, element 0 at slot 0
+    void reallocate(size_t new_cap) {
+        T* new_buf = allocate(new_cap);
+        if (count) alloc_tracker::on_realloc_copy(alloc_kind::other, count*sizeof(T));
+        size_t first = count < cap - head ? count : cap - head;
+        if (count) {
+            relocate(new_buf, buf + head, first);
+            relocate(new_buf + first, buf, count - first);
+        }
+        deallocate(buf, cap);
+        buf = new_buf;
+        head = 0;
+        cap = new_cap;
+    }
+
+    void grow_if_full() {
+        if (count == cap) reallocate(cap == 0 ? 8 : cap * 2);
+    }
+
+    // logical index of p if it points into the buffer, npos otherwise
+    // (compared as integers: p may belong to an unrelated array)
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    size_t index_of(const T* p) const {
+        uintptr_t a = reinterpret_cast<uintptr_t>(p), lo = reinterpret_cast<uintptr_t>(buf);
+        if (cap == 0 || a < lo || a >= lo + cap*sizeof(T)) return npos;
+        return (size_t(p - buf) - head) & mask();
+    }
+
+    void destroy_all() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i=0; i<count; i++) buf[slot(i)].~T();
+        }
+    }
+
+public:
+    // Iterator - logical index into the deque
+    template<bool Const>
+    struct basic_iterator {
+        using D = std::conditional_t<Const, const deque, deque>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        D* d;
+        size_t i;
+        basic_iterator(D* dq, size_t idx) : d(dq), i(idx) {}
+        reference operator*() const { return (*d)[i]; }
+        basic_iterator& operator++() { ++i; return *this; }
+        basic_iterator& operator--() { --i; return *this; }
+        basic_iterator operator+(ptrdiff_t n) const { return basic_iterator(d, i + n); }
+        ptrdiff_t operator-(const basic_iterator& other) const { return ptrdiff_t(i) - ptrdiff_t(other.i); }
+        bool operator==(const basic_iterator& other) const { return i == other.i; }
+        bool operator!=(const basic_iterator& other) const { return i != other.i; }
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, count); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+    // Constructors
+    deque() : buf(nullptr), head(0), count(0), cap(0) {}
+
+    // Reserve room for at least n elements
+    explicit deque(size_t n) : deque() { reserve(n); }
+
+    deque(const deque& other) : deque() {
+        reserve(other.count);
+        for (size_t i=0; i<other.count; i++) new (buf+i) T(other[i]);
+        count = other.count;
+    }
+
+    deque(deque&& other) noexcept
+        : buf(other.buf), head(other.head), count(other.count), cap(other.cap) {
+        other.buf = nullptr;
+        other.head = other.count = other.cap = 0;
+    }
+
+    deque& operator=(const deque& other) {
+        if (this != &other) {
+            deque tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    deque& operator=(deque&& other) noexcept {
+        if (this != &other) {
+            destroy_all();
+            deallocate(buf, cap);
+            buf = other.buf;
+            head = other.head;
+            count = other.count;
+            cap = other.cap;
+            other.buf = nullptr;
+            other.head = other.count = other.cap = 0;
+        }
+        return *this;
+    }
+
+    ~deque() {
+        destroy_all();
+        deallocate(buf, cap);
+    }
+
+    // Element access
+    T& operator[](size_t i) { return buf[slot(i)]; }
+    const T& operator[](size_t i) const { return buf[slot(i)]; }
+    T& at(size_t i) {
+        if (i >= count) throw std::out_of_range("deque::at index out of range");
+        return buf[slot(i)];
+    }
+    const T& at(size_t i) const {
+        if (i >= count) throw std::out_of_range("deque::at index out of range");
+        return buf[slot(i)];
+    }
+    T& front() { return buf[head]; }
+    const T& front() const { return buf[head]; }
+    T& back() { return buf[slot(count - 1)]; }
+    const T& back() const { return buf[slot(count - 1)]; }
+
+    // Capacity
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return cap; }
+    void reserve(size_t n) {
+        if (n > cap) reallocate(round_up(n));
+    }
+
+    // Modifiers
+    void push_back(const T& value) {
+        if (count == cap) {
+            T copy(value);              // value may be one of ours, moved by the growth
+            push_back(std::move(copy));
+            return;
+        }
+        new (buf + slot(count)) T(value);
+        count++;
+    }
+    void push_back(T&& value) {
+        grow_if_full();
+        new (buf + slot(count)) T(std::move(value));
+        count++;
+    }
+    void push_front(const T& value) {
+        if (count == cap) {
+            T copy(value);
+            push_front(std::move(copy));
+            return;
+        }
+        size_t s = (head - 1) & mask();
+        new (buf + s) T(value);
+        head = s;
+        count++;
+    }
+    void push_front(T&& value) {
+        grow_if_full();
+        size_t s = (head - 1) & mask();
+        new (buf + s) T(std::move(value));
+        head = s;
+        count++;
+    }
+
+    void pop_back() {
+        if (count == 0) throw std::out_of_range("Empty deque");
+        count--;
+        buf[slot(count)].~T();
+    }
+    void pop_front() {
+        if (count == 0) throw std::out_of_range("Empty deque");
+        buf[head].~T();
+        head = (head + 1) & mask();
+        count--;
+    }
+
+    // Drop the first n elements, e.g. after writev consumed them
+    void pop_front_n(size_t n) {
+        if (n > count) throw std::out_of_range("deque::pop_front_n past end");
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i=0; i<n; i++) buf[slot(i)].~T();
+        }
+        head = n == count ? 0 : slot(n);
+        count -= n;
+    }
+
+    // Append n elements - at most two memcpys for trivially copyable T
+    // src may point into this deque: growth moves it, so it is found again
+    void append(const T* src, size_t n) {
+        if (count + n > cap) {
+            size_t at = index_of(src);
+            reallocate(round_up(count + n));
+            if (at != npos) src = buf + at;     // unwrapped: element i is at slot i
+        }
+        size_t tail = slot(count);
+        size_t first = n < cap - tail ? n : cap - tail;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (first) std::memcpy(static_cast<void*>(buf + tail), src, first*sizeof(T));
+            if (n - first) std::memcpy(static_cast<void*>(buf), src + first, (n - first)*sizeof(T));
+        } else {
+            for (size_t i=0; i<first; i++) new (buf + tail + i) T(src[i]);
+            for (size_t i=first; i<n; i++) new (buf + i - first) T(src[i]);
+        }
+        count += n;
+    }
+
+    void clear() {
+        destroy_all();
+        head = 0;
+        count = 0;
+    }
+
+    void swap(deque& other) noexcept {
+        std::swap(buf, other.buf);
+        std::swap(head, other.head);
+        std::swap(count, other.count);
+        std::swap(cap, other.cap);
+    }
+
+    // Contents as two contiguous runs in order; the second is empty unless
+    // the ring wraps
+    std::pair<std::span<T>, std::span<T>> spans() {
+        size_t first = count < cap - head ? count : cap - head;
+        return {std::span<T>(buf + head, first), std::span<T>(buf, count - first)};
+    }
+    std::pair<std::span<const T>, std::span<const T>> spans() const {
+        size_t first = count < cap - head ? count : cap - head;
+        return {std::span<const T>(buf + head, first), std::span<const T>(buf, count - first)};
+    }
+};
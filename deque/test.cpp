@@ -0,0 +1,156 @@
+#include "gtest/gtest.h"
+#include "deque.hpp"
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <sys/uio.h>
+#include <unistd.h>
+
+TEST(DequeTest, PushPopBothEnds) {
+    deque<int> d;
+    EXPECT_TRUE(d.empty());
+    d.push_back(2);
+    d.push_back(3);
+    d.push_front(1);
+    d.push_front(0);
+    ASSERT_EQ(d.size(), 4);
+    for (int i=0; i<4; i++) EXPECT_EQ(d[i], i);
+    EXPECT_EQ(d.front(), 0);
+    EXPECT_EQ(d.back(), 3);
+
+    d.pop_front();
+    d.pop_back();
+    EXPECT_EQ(d.front(), 1);
+    EXPECT_EQ(d.back(), 2);
+    EXPECT_THROW(d.at(2), std::out_of_range);
+    d.pop_back();
+    d.pop_back();
+    EXPECT_THROW(d.pop_front(), std::out_of_range);
+}
+
+TEST(DequeTest, MatchesStdDequeUnderRandomOps) {
+    deque<std::string> d;                           // non-trivial T takes the move path
+    std::deque<std::string> expected;
+    std::mt19937 rng(7);
+    for (int step=0; step<20000; step++) {
+        std::string s = std::to_string(step) + std::string(step % 20, 'x');
+        switch (rng() % 4) {
+            case 0: d.push_back(s); expected.push_back(s); break;
+            case 1: d.push_front(s); expected.push_front(s); break;
+            case 2: if (!expected.empty()) { d.pop_back(); expected.pop_back(); } break;
+            case 3: if (!expected.empty()) { d.pop_front(); expected.pop_front(); } break;
+        }
+        ASSERT_EQ(d.size(), expected.size());
+        if (!expected.empty()) {
+            ASSERT_EQ(d.front(), expected.front());
+            ASSERT_EQ(d.back(), expected.back());
+            size_t i = rng() % expected.size();
+            ASSERT_EQ(d[i], expected[i]);
+        }
+    }
+    size_t i = 0;
+    for (const std::string& s : d) EXPECT_EQ(s, expected[i++]);
+}
+
+TEST(DequeTest, CapacityIsPowerOfTwo) {
+    deque<int> d(100);
+    EXPECT_EQ(d.capacity(), 128);
+    for (int i=0; i<129; i++) d.push_back(i);
+    EXPECT_EQ(d.capacity(), 256);
+
+    // steady-state queue traffic wraps around without growing
+    deque<int> q(16);
+    for (int i=0; i<10000; i++) {
+        q.push_back(i);
+        if (q.size() > 10) q.pop_front();
+    }
+    EXPECT_EQ(q.capacity(), 16);
+    EXPECT_EQ(q.front(), 9990);
+}
+
+TEST(DequeTest, GrowthUnwrapsRing) {
+    deque<std::unique_ptr<int>> d(8);               // move-only T
+    for (int i=0; i<6; i++) d.push_back(std::make_unique<int>(i));
+    for (int i=0; i<4; i++) d.pop_front();
+    for (int i=6; i<14; i++) d.push_back(std::make_unique<int>(i));   // wraps, then grows
+    ASSERT_EQ(d.size(), 10);
+    for (int i=0; i<10; i++) EXPECT_EQ(*d[i], i + 4);
+    auto [first, second] = d.spans();
+    EXPECT_EQ(first.size(), 10);                    // contiguous again after growth
+    EXPECT_TRUE(second.empty());
+}
+
+TEST(DequeTest, TwoSpanViewsForWritev) {
+    deque<char> d(16);
+    const char msg[] = "0123456789abcdef";
+    d.append(msg, 12);
+    d.pop_front_n(10);
+    d.append(msg + 12, 4);
+    d.append(msg, 8);                               // wraps: "ab" + "cdef" + "01234567"
+    ASSERT_EQ(d.size(), 14);
+
+    auto [first, second] = d.spans();
+    EXPECT_EQ(first.size() + second.size(), d.size());
+    EXPECT_FALSE(second.empty());
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    iovec iov[2] = {{first.data(), first.size()}, {second.data(), second.size()}};
+    ASSERT_EQ(writev(fds[1], iov, 2), 14);
+    char out[15] = {};
+    ASSERT_EQ(read(fds[0], out, 14), 14);
+    close(fds[0]);
+    close(fds[1]);
+    EXPECT_STREQ(out, "abcdef01234567");
+
+    d.pop_front_n(d.size());
+    EXPECT_TRUE(d.empty());
+    EXPECT_THROW(d.pop_front_n(1), std::out_of_range);
+}
+
+TEST(DequeTest, AppendAndPushFromOwnElements) {
+    // the source lives in the buffer that growth frees
+    deque<int> d(8);
+    for (int i=0; i<6; i++) d.push_back(i);
+    d.pop_front_n(2);
+    d.push_front(1);                                // head not at slot 0
+    auto [first, second] = d.spans();
+    d.append(first.data(), first.size());           // 5 + 5 > 8: grows
+    ASSERT_EQ(d.size(), 10);
+    for (size_t i=0; i<10; i++) EXPECT_EQ(d[i], int(i % 5) + 1);
+
+    deque<std::string> s;
+    for (int i=0; i<8; i++) s.push_back(std::string(20, char('a' + i)));
+    s.push_back(s[0]);                              // full: grows
+    s.push_front(s[8]);
+    EXPECT_EQ(s.front(), std::string(20, 'a'));
+    EXPECT_EQ(s.back(), std::string(20, 'a'));
+    s.append(&s[1], 7);                             // 10 + 7 > 16: grows
+    ASSERT_EQ(s.size(), 17);
+    EXPECT_EQ(s[10], std::string(20, 'a'));
+    EXPECT_EQ(s.back(), std::string(20, 'g'));
+}
+
+TEST(DequeTest, CopyMoveAndClear) {
+    deque<std::string> a;
+    for (int i=0; i<20; i++) a.push_front(std::to_string(i));
+    deque<std::string> b(a);
+    deque<std::string> c(std::move(a));
+    EXPECT_TRUE(a.empty());
+    ASSERT_EQ(b.size(), 20);
+    for (int i=0; i<20; i++) EXPECT_EQ(b[i], c[i]);
+    EXPECT_EQ(b.front(), "19");
+
+    a = b;
+    b.clear();
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(a.back(), "0");
+    b.push_back("x");
+    EXPECT_EQ(b.front(), "x");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
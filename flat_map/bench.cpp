@@ -0,0 +1,85 @@
+// Random hit lookups: flat_map (branchless / Eytzinger, single / lookup_many)
+// vs std::map vs std::unordered_map, 1K keys up to max_keys (default 10M)
+// g++ -std=c++20 -O2 bench.cpp -o bench && ./bench [max_keys]   (100000000 for 100M, ~10 GB)
+#include "flat_map.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+template<typename F>
+double ns_per_op(size_t ops, F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / double(ops);
+}
+
+template<typename Map>
+double single_lookups(const Map& m, const std::vector<uint64_t>& queries) {
+    uint64_t sum = 0;
+    double ns = ns_per_op(queries.size(), [&] {
+        for (uint64_t q : queries) sum += *m.find(q);
+    });
+    if (sum == 42) std::puts("");
+    return ns;
+}
+
+template<typename Map>
+double batched_lookups(const Map& m, const std::vector<uint64_t>& queries) {
+    std::vector<const uint64_t*> results(queries.size());
+    uint64_t sum = 0;
+    double ns = ns_per_op(queries.size(), [&] {
+        m.lookup_many(queries.data(), queries.size(), results.data());
+        for (const uint64_t* r : results) sum += *r;
+    });
+    if (sum == 42) std::puts("");
+    return ns;
+}
+
+int main(int argc, char** argv) {
+    size_t max_keys = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 10'000'000;
+    const size_t lookups = 1'000'000;
+    std::mt19937_64 rng(1);
+
+    std::printf("%10s %10s %10s %10s %10s %10s %10s   (ns/lookup)\n",
+        "keys", "std::map", "unordered", "branchless", "eytzinger", "many/bl", "many/eytz");
+    for (size_t n = 1000; n <= max_keys; n *= 10) {
+        std::vector<std::pair<uint64_t, uint64_t>> items(n);
+        for (auto& [k, v] : items) k = v = rng();
+        std::vector<uint64_t> queries(lookups);
+        for (auto& q : queries) q = items[rng() % n].first;
+
+        double tree, hash;
+        {
+            std::map<uint64_t, uint64_t> m(items.begin(), items.end());
+            tree = ns_per_op(lookups, [&] {
+                uint64_t sum = 0;
+                for (uint64_t q : queries) sum += m.find(q)->second;
+                if (sum == 42) std::puts("");
+            });
+        }
+        {
+            std::unordered_map<uint64_t, uint64_t> m(items.begin(), items.end());
+            hash = ns_per_op(lookups, [&] {
+                uint64_t sum = 0;
+                for (uint64_t q : queries) sum += m.find(q)->second;
+                if (sum == 42) std::puts("");
+            });
+        }
+        double bl, bl_many, ey, ey_many;
+        {
+            flat_map<uint64_t, uint64_t> m(items.begin(), items.end());
+            bl = single_lookups(m, queries);
+            bl_many = batched_lookups(m, queries);
+        }
+        {
+            flat_map<uint64_t, uint64_t, std::less<uint64_t>, eytzinger_search> m(items.begin(), items.end());
+            ey = single_lookups(m, queries);
+            ey_many = batched_lookups(m, queries);
+        }
+        std::printf("%10zu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", n, tree, hash, bl, ey, bl_many, ey_many);
+    }
+}
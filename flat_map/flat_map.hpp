@@ -0,0 +1,310 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include "../vector/vector.hpp"
+
+// Search policies for flat_map / flat_set - both return lower_bound positions
+// in the sorted key array
+// branchless_search - binary search whose only data-dependent step is a
+//                     conditional move, so there are no mispredicted branches
+// eytzinger_search  - extra copy of the keys in BFS (heap) order plus a rank
+//                     table; probes walk down the array and the next levels
+//                     are prefetched, which wins once keys spill out of cache
+struct branchless_search {
+    template<typename K>
+    struct index {
+        void build(const K*, size_t) {}
+
+        template<typename Compare>
+        size_t lower_bound(const K* sorted, size_t n, const K& key, Compare comp) const {
+            if (n == 0) return 0;
+            const K* base = sorted;
+            while (n > 1) {
+                size_t half = n / 2;
+                base = comp(base[half], key) ? base + half : base;
+                n -= half;
+            }
+            return size_t(base - sorted) + comp(*base, key);
+        }
+
+        // queries advance in lockstep (every probe sequence has the same length),
+        // so a group's cache misses overlap instead of queueing
+        template<typename Compare>
+        void lower_bound_many(const K* sorted, size_t n, const K* queries, size_t m,
+                              size_t* out, Compare comp) const {
+            constexpr size_t group = 16;
+            for (size_t start=0; start<m; start+=group) {
+                size_t g = std::min(group, m - start);
+                const K* q = queries + start;
+                if (n == 0) {
+                    for (size_t j=0; j<g; j++) out[start + j] = 0;
+                    continue;
+                }
+                const K* base[group];
+                for (size_t j=0; j<g; j++) base[j] = sorted;
+                for (size_t len = n; len > 1; ) {
+                    size_t half = len / 2;
+                    for (size_t j=0; j<g; j++) {
+                        __builtin_prefetch(base[j] + half / 2);
+                        __builtin_prefetch(base[j] + half + half / 2);
+                        base[j] = comp(base[j][half], q[j]) ? base[j] + half : base[j];
+                    }
+                    len -= half;
+                }
+                for (size_t j=0; j<g; j++) out[start + j] = size_t(base[j] - sorted) + comp(*base[j], q[j]);
+            }
+        }
+    };
+};
+
+struct eytzinger_search {
+    template<typename K>
+    struct index {
+        vector<K> tree;             // 1-based BFS order, tree[0] unused
+        vector<uint32_t> rank;      // tree position -> sorted position
+
+        // a cache line holds this many keys: prefetching tree[i * per_line]
+        // fetches the node's descendants four levels down
+        static constexpr size_t per_line = sizeof(K) < 64 ? 64 / sizeof(K) : 1;
+
+        static void prefetch(const K* base, size_t i) {
+            __builtin_prefetch(reinterpret_cast<const char*>(base) + i * per_line * sizeof(K));
+        }
+
+        void fill(const K* sorted, size_t n, size_t k, size_t& next) {
+            if (k > n) return;
+            fill(sorted, n, 2 * k, next);
+            tree[k] = sorted[next];
+            rank[k] = uint32_t(next++);
+            fill(sorted, n, 2 * k + 1, next);
+        }
+
+        void build(const K* sorted, size_t n) {
+            if (n >= UINT32_MAX) throw std::length_error("eytzinger_search: too many keys");
+            tree = vector<K>(n + 1);
+            rank = vector<uint32_t>(n + 1);
+            for (size_t i=0; i<=n; i++) {
+                tree.push_back(i ? sorted[0] : K());
+                rank.push_back(0);
+            }
+            size_t next = 0;
+            fill(sorted, n, 1, next);
+        }
+
+        // leaving the tree, the path's trailing 1-bits are right turns; shifting
+        // them (and the last left turn) off gives the lower_bound node, 0 = end
+        size_t finish(size_t i, size_t n) const {
+            i >>= __builtin_ffsll(static_cast<long long>(~i));
+            return i ? rank[i] : n;
+        }
+
+        // every path takes floor(log2 n) full steps, then at most one more:
+        // that last step reads tree[0] instead of running off the end
+        static int full_levels(size_t n) { return 63 - __builtin_clzll(n); }
+
+        template<typename Compare>
+        size_t step_last(const K* t, size_t i, size_t n, const K& key, Compare comp) const {
+            size_t safe = i <= n ? i : 0;
+            size_t next = 2 * i + comp(t[safe], key);
+            return i <= n ? next : i;
+        }
+
+        template<typename Compare>
+        size_t lower_bound(const K*, size_t n, const K& key, Compare comp) const {
+            if (n == 0) return 0;
+            const K* t = &tree[0];
+            size_t i = 1;
+            for (int level = full_levels(n); level > 0; level--) {
+                prefetch(t, i);
+                i = 2 * i + comp(t[i], key);
+            }
+            return finish(step_last(t, i, n, key, comp), n);
+        }
+
+        template<typename Compare>
+        void lower_bound_many(const K*, size_t n, const K* queries, size_t m,
+                              size_t* out, Compare comp) const {
+            constexpr size_t group = 16;
+            if (n == 0) {
+                for (size_t j=0; j<m; j++) out[j] = 0;
+                return;
+            }
+            const K* t = &tree[0];
+            for (size_t start=0; start<m; start+=group) {
+                size_t g = std::min(group, m - start);
+                const K* q = queries + start;
+                size_t idx[group];
+                for (size_t j=0; j<g; j++) idx[j] = 1;
+                for (int level = full_levels(n); level > 0; level--) {
+                    for (size_t j=0; j<g; j++) {
+                        size_t i = 2 * idx[j] + comp(t[idx[j]], q[j]);
+                        prefetch(t, i);
+                        idx[j] = i;
+                    }
+                }
+                for (size_t j=0; j<g; j++) out[start + j] = finish(step_last(t, idx[j], n, q[j], comp), n);
+            }
+        }
+    };
+};
+
+// Read-mostly sorted map: keys and values in two parallel vectors
+// - built in bulk: sort once, then drop duplicate keys (first occurrence wins)
+// - lookups touch only the key array until the match, so more keys per cache line
+// - no single-element insert/erase: rebuild from a new range instead
+template<typename K, typename V, typename Compare = std::less<K>, typename Search = branchless_search>
+class flat_map {
+private:
+    vector<K> keys;
+    vector<V> values;
+    typename Search::template index<K> search;
+    Compare comp;
+
+    const K* key_data() const { return keys.getSize() ? &keys[0] : nullptr; }
+
+    bool matches(size_t pos, const K& key) const {
+        return pos < keys.getSize() && !comp(key, keys[pos]);
+    }
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    flat_map() = default;
+
+    // Bulk construction from unsorted (key, value) pairs
+    template<typename It>
+    flat_map(It first, It last, Compare c = Compare()) : comp(c) {
+        vector<std::pair<K, V>> items(size_t(std::distance(first, last)));
+        for (; first != last; ++first) items.push_back(std::pair<K, V>(*first));
+
+        size_t n = items.getSize();
+        std::pair<K, V>* p = n ? &items[0] : nullptr;
+        std::stable_sort(p, p + n, [&](const auto& a, const auto& b) { return comp(a.first, b.first); });
+
+        keys = vector<K>(n);
+        values = vector<V>(n);
+        for (size_t i=0; i<n; i++) {
+            size_t kept = keys.getSize();
+            if (kept && !comp(keys[kept - 1], p[i].first)) continue;     // duplicate of the last kept key
+            keys.push_back(std::move(p[i].first));
+            values.push_back(std::move(p[i].second));
+        }
+        search.build(key_data(), keys.getSize());
+    }
+
+    flat_map(std::initializer_list<std::pair<K, V>> init, Compare c = Compare())
+        : flat_map(init.begin(), init.end(), c) {}
+
+    // Capacity
+    size_t size() const { return keys.getSize(); }
+    bool empty() const { return keys.getSize() == 0; }
+
+    // Lookup
+    size_t lower_bound(const K& key) const {
+        return search.lower_bound(key_data(), keys.getSize(), key, comp);
+    }
+    size_t index_of(const K& key) const {
+        size_t pos = lower_bound(key);
+        return matches(pos, key) ? pos : npos;
+    }
+    const V* find(const K& key) const {
+        size_t pos = lower_bound(key);
+        return matches(pos, key) ? &values[pos] : nullptr;
+    }
+    V* find(const K& key) {
+        return const_cast<V*>(std::as_const(*this).find(key));
+    }
+    bool contains(const K& key) const { return index_of(key) != npos; }
+
+    const V& at(const K& key) const {
+        const V* v = find(key);
+        if (!v) throw std::out_of_range("flat_map::at key not found");
+        return *v;
+    }
+
+    // results[i] = value for queries[i] or nullptr; queries are searched in
+    // interleaved groups with prefetching, so misses overlap
+    void lookup_many(const K* queries, size_t count, const V** results) const {
+        constexpr size_t chunk = 256;
+        size_t pos[chunk];
+        for (size_t start=0; start<count; start+=chunk) {
+            size_t m = std::min(chunk, count - start);
+            search.lower_bound_many(key_data(), keys.getSize(), queries + start, m, pos, comp);
+            for (size_t j=0; j<m; j++) {
+                results[start + j] = matches(pos[j], queries[start + j]) ? &values[pos[j]] : nullptr;
+            }
+        }
+    }
+
+    // Positional access, in key order
+    const K& key_at(size_t i) const { return keys[i]; }
+    const V& value_at(size_t i) const { return values[i]; }
+    V& value_at(size_t i) { return values[i]; }
+};
+
+// Read-mostly sorted set - flat_map without the values
+template<typename K, typename Compare = std::less<K>, typename Search = branchless_search>
+class flat_set {
+private:
+    vector<K> keys;
+    typename Search::template index<K> search;
+    Compare comp;
+
+    const K* key_data() const { return keys.getSize() ? &keys[0] : nullptr; }
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    flat_set() = default;
+
+    // Bulk construction from unsorted keys
+    template<typename It>
+    flat_set(It first, It last, Compare c = Compare()) : comp(c) {
+        vector<K> items(size_t(std::distance(first, last)));
+        for (; first != last; ++first) items.push_back(K(*first));
+
+        size_t n = items.getSize();
+        K* p = n ? &items[0] : nullptr;
+        std::sort(p, p + n, comp);
+
+        keys = vector<K>(n);
+        for (size_t i=0; i<n; i++) {
+            size_t kept = keys.getSize();
+            if (kept && !comp(keys[kept - 1], p[i])) continue;
+            keys.push_back(std::move(p[i]));
+        }
+        search.build(key_data(), keys.getSize());
+    }
+
+    flat_set(std::initializer_list<K> init, Compare c = Compare())
+        : flat_set(init.begin(), init.end(), c) {}
+
+    size_t size() const { return keys.getSize(); }
+    bool empty() const { return keys.getSize() == 0; }
+
+    size_t lower_bound(const K& key) const {
+        return search.lower_bound(key_data(), keys.getSize(), key, comp);
+    }
+    size_t index_of(const K& key) const {
+        size_t pos = lower_bound(key);
+        return pos < keys.getSize() && !comp(key, keys[pos]) ? pos : npos;
+    }
+    bool contains(const K& key) const { return index_of(key) != npos; }
+
+    // results[i] = index of queries[i] or npos
+    void lookup_many(const K* queries, size_t count, size_t* results) const {
+        search.lower_bound_many(key_data(), keys.getSize(), queries, count, results, comp);
+        for (size_t j=0; j<count; j++) {
+            size_t pos = results[j];
+            if (pos >= keys.getSize() || comp(queries[j], keys[pos])) results[j] = npos;
+        }
+    }
+
+    const K& operator[](size_t i) const { return keys[i]; }
+};
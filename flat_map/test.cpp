@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include "flat_map.hpp"
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+template<typename Search>
+static void check_against_std_map(size_t n) {
+    std::mt19937_64 rng(n);
+    std::vector<std::pair<uint64_t, int>> input;
+    std::map<uint64_t, int> expected;
+    for (size_t i=0; i<n; i++) {
+        uint64_t k = rng() % (n * 2 + 1);
+        input.push_back({k, int(i)});
+        expected.emplace(k, int(i));            // first occurrence wins, like flat_map
+    }
+
+    flat_map<uint64_t, int, std::less<uint64_t>, Search> m(input.begin(), input.end());
+    ASSERT_EQ(m.size(), expected.size());
+
+    std::vector<uint64_t> queries;
+    for (size_t k=0; k<n * 2 + 2; k++) queries.push_back(k);
+    std::vector<const int*> results(queries.size());
+    m.lookup_many(queries.data(), queries.size(), results.data());
+
+    for (size_t q=0; q<queries.size(); q++) {
+        auto it = expected.find(queries[q]);
+        const int* v = m.find(queries[q]);
+        if (it == expected.end()) {
+            EXPECT_EQ(v, nullptr) << queries[q];
+            EXPECT_EQ(results[q], nullptr) << queries[q];
+        } else {
+            ASSERT_NE(v, nullptr) << queries[q];
+            EXPECT_EQ(*v, it->second);
+            EXPECT_EQ(results[q], v);
+        }
+        EXPECT_EQ(m.lower_bound(queries[q]), size_t(std::distance(expected.begin(), expected.lower_bound(queries[q]))));
+    }
+}
+
+TEST(FlatMapTest, MatchesStdMapBranchless) {
+    for (size_t n : {0, 1, 2, 3, 7, 8, 100, 1000, 4097}) check_against_std_map<branchless_search>(n);
+}
+
+TEST(FlatMapTest, MatchesStdMapEytzinger) {
+    for (size_t n : {0, 1, 2, 3, 7, 8, 100, 1000, 4097}) check_against_std_map<eytzinger_search>(n);
+}
+
+TEST(FlatMapTest, BulkBuildSortsAndDedups) {
+    flat_map<int, std::string> m{{5, "five"}, {1, "one"}, {3, "three"}, {1, "uno"}, {5, "cinco"}};
+    ASSERT_EQ(m.size(), 3);
+    EXPECT_EQ(m.key_at(0), 1);
+    EXPECT_EQ(m.key_at(1), 3);
+    EXPECT_EQ(m.key_at(2), 5);
+    EXPECT_EQ(m.at(1), "one");
+    EXPECT_EQ(m.at(5), "five");
+    EXPECT_THROW(m.at(2), std::out_of_range);
+    EXPECT_EQ(m.index_of(4), m.npos);
+
+    *m.find(3) = "drei";                     // values stay writable
+    EXPECT_EQ(m.value_at(1), "drei");
+}
+
+TEST(FlatMapTest, CustomCompareAndStringKeys) {
+    std::vector<std::pair<std::string, int>> input{{"pear", 1}, {"apple", 2}, {"fig", 3}};
+    flat_map<std::string, int, std::greater<std::string>, eytzinger_search> m(input.begin(), input.end());
+    EXPECT_EQ(m.key_at(0), "pear");         // descending
+    EXPECT_EQ(m.key_at(2), "apple");
+    EXPECT_EQ(*m.find("fig"), 3);
+    EXPECT_FALSE(m.contains("kiwi"));
+}
+
+TEST(FlatSetTest, ContainsAndLookupMany) {
+    std::vector<int> input{9, 2, 7, 2, 4, 9, 1};
+    flat_set<int> s(input.begin(), input.end());
+    flat_set<int, std::less<int>, eytzinger_search> e(input.begin(), input.end());
+    ASSERT_EQ(s.size(), 5);
+    EXPECT_EQ(s[0], 1);
+    EXPECT_EQ(s[4], 9);
+
+    int queries[] = {0, 1, 2, 3, 4, 7, 8, 9, 10};
+    size_t a[9], b[9];
+    s.lookup_many(queries, 9, a);
+    e.lookup_many(queries, 9, b);
+    for (int i=0; i<9; i++) {
+        EXPECT_EQ(a[i], s.index_of(queries[i]));
+        EXPECT_EQ(b[i], a[i]);
+        EXPECT_EQ(s.contains(queries[i]), a[i] != s.npos);
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
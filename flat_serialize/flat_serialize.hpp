@@ -0,0 +1,455 @@
+#pragma once
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+#include "../vector/vector.hpp"
+#include "../string/string.hpp"
+#include "../unique_ptr/unique_ptr.hpp"
+
+// Flat binary serialization - the file layout is the in-memory layout
+//
+//   header (32 B)   magic "FLATSER\0", version, endian marker, alignment
+//   section 0       each section starts on a 64-byte boundary
+//   section 1 ...
+//   table           {offset, size, kind, elem_size} per section
+//   trailer (32 B)  table offset, section count, CRC32C of everything before it
+//
+// Section payloads (uint64 counts/offsets, host byte order):
+//   array      count * elem_size raw bytes
+//   str        chars, then a '\0' not counted in the size
+//   str_list   count, offsets[count+1] (bytes into chars), chars
+//   nested     count, offsets[count+1] (elements into data), pad to 16, data
+//
+// flat_writer streams sections straight to a FILE* (only the small table is
+// kept in memory); flat_reader validates header/trailer (and optionally the
+// checksum) and hands out views pointing into the buffer - no parsing, no
+// allocation, so a mmap'd file is usable as soon as it is mapped
+inline constexpr uint16_t flat_format_version = 1;
+inline constexpr size_t flat_alignment = 64;
+
+enum class flat_kind : uint32_t { array = 1, str = 2, str_list = 3, nested = 4 };
+
+struct flat_header {
+    char magic[8];
+    uint16_t version;
+    uint16_t endian;            // 0x0102 as written by the producer
+    uint32_t alignment;
+    uint64_t reserved[2];
+};
+
+struct flat_section {
+    uint64_t offset;
+    uint64_t size;
+    flat_kind kind;
+    uint32_t elem_size;
+};
+
+struct flat_trailer {
+    uint64_t table_offset;
+    uint64_t section_count;
+    uint32_t checksum;
+    uint32_t reserved;
+    char magic[8];
+};
+
+static_assert(sizeof(flat_header) == 32 && sizeof(flat_section) == 24 && sizeof(flat_trailer) == 32);
+
+// CRC32C (Castagnoli) - SSE4.2 crc32 instruction when available, table otherwise
+inline uint32_t crc32c(uint32_t crc, const void* data, size_t n) noexcept {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#if defined(__SSE4_2__)
+    uint64_t c = crc;
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        c = _mm_crc32_u64(c, word);
+    }
+    crc = uint32_t(c);
+    for (; n; n--) crc = _mm_crc32_u8(crc, *p++);
+#else
+    static constexpr auto table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i=0; i<256; i++) {
+            uint32_t r = i;
+            for (int b=0; b<8; b++) r = (r >> 1) ^ (0x82F63B78u & (0u - (r & 1)));
+            t[i] = r;
+        }
+        return t;
+    }();
+    for (; n; n--) crc = table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+#endif
+    return ~crc;
+}
+
+// Views - pointers into the serialized buffer, valid while it is mapped
+template<typename T>
+class flat_span {
+private:
+    const T* ptr;
+    size_t count;
+
+public:
+    flat_span() noexcept : ptr(nullptr), count(0) {}
+    flat_span(const T* p, size_t n) noexcept : ptr(p), count(n) {}
+
+    const T& operator[](size_t i) const noexcept { return ptr[i]; }
+    const T* data() const noexcept { return ptr; }
+    size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    const T* begin() const noexcept { return ptr; }
+    const T* end() const noexcept { return ptr + count; }
+};
+
+// vector<string> section
+class flat_string_list {
+private:
+    const uint64_t* offsets;
+    const char* chars;
+    size_t count;
+
+public:
+    flat_string_list(const uint64_t* offs, const char* c, size_t n) noexcept
+        : offsets(offs), chars(c), count(n) {}
+
+    std::string_view operator[](size_t i) const noexcept {
+        return std::string_view(chars + offsets[i], size_t(offsets[i + 1] - offsets[i]));
+    }
+    size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+};
+
+// vector<vector<T>> section
+template<typename T>
+class flat_nested {
+private:
+    const uint64_t* offsets;
+    const T* elems;
+    size_t count;
+
+public:
+    flat_nested(const uint64_t* offs, const T* e, size_t n) noexcept
+        : offsets(offs), elems(e), count(n) {}
+
+    flat_span<T> operator[](size_t i) const noexcept {
+        return flat_span<T>(elems + offsets[i], size_t(offsets[i + 1] - offsets[i]));
+    }
+    size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+};
+
+// Streaming writer - each write() appends one section and returns its index
+// finish() writes the table and trailer; the destructor calls it if needed
+class flat_writer {
+private:
+    std::FILE* out;
+    uint64_t offset = 0;
+    uint32_t crc = 0;
+    std::vector<flat_section> table;
+    bool finished = false;
+
+    void emit(const void* p, size_t n) {
+        if (n == 0) return;
+        if (std::fwrite(p, 1, n, out) != n) throw std::runtime_error("flat_writer: write failed");
+        crc = crc32c(crc, p, n);
+        offset += n;
+    }
+
+    void emit_u64(uint64_t v) { emit(&v, sizeof(v)); }
+
+    void pad_to(size_t align) {
+        static constexpr unsigned char zeros[flat_alignment] = {};
+        emit(zeros, size_t((align - offset % align) % align));
+    }
+
+    void begin_section(flat_kind kind, uint32_t elem_size) {
+        if (finished) throw std::logic_error("flat_writer: write after finish");
+        pad_to(flat_alignment);
+        table.push_back({offset, 0, kind, elem_size});
+    }
+
+    size_t end_section() {
+        table.back().size = offset - table.back().offset;
+        return table.size() - 1;
+    }
+
+public:
+    explicit flat_writer(std::FILE* output) : out(output) {
+        flat_header h{};
+        std::memcpy(h.magic, "FLATSER", 8);
+        h.version = flat_format_version;
+        h.endian = 0x0102;
+        h.alignment = uint32_t(flat_alignment);
+        emit(&h, sizeof(h));
+    }
+
+    ~flat_writer() {
+        if (!finished) {
+            try { finish(); } catch (...) {}
+        }
+    }
+
+    flat_writer(const flat_writer&) = delete;
+    flat_writer& operator=(const flat_writer&) = delete;
+
+    // n trivially copyable elements
+    template<typename T>
+    size_t write_array(const T* p, size_t n) {
+        static_assert(std::is_trivially_copyable_v<T>, "flat arrays hold trivially copyable elements");
+        static_assert(alignof(T) <= flat_alignment, "element over-aligned for flat layout");
+        begin_section(flat_kind::array, uint32_t(sizeof(T)));
+        emit(p, n * sizeof(T));
+        return end_section();
+    }
+
+    template<typename T>
+    size_t write(const vector<T>& v) {
+        return write_array(v.getSize() ? &v[0] : static_cast<const T*>(nullptr), v.getSize());
+    }
+
+    size_t write(std::string_view s) {
+        begin_section(flat_kind::str, 1);
+        emit(s.data(), s.size());
+        emit("", 1);
+        table.back().size = offset - 1 - table.back().offset;
+        return table.size() - 1;
+    }
+
+    size_t write(const string& s) {
+        return write(std::string_view(s.c_str(), s.getSize()));
+    }
+
+    size_t write(const vector<string>& v) {
+        size_t n = v.getSize();
+        begin_section(flat_kind::str_list, 1);
+        emit_u64(n);
+        uint64_t pos = 0;
+        emit_u64(pos);
+        for (size_t i=0; i<n; i++) emit_u64(pos += v[i].getSize());
+        for (size_t i=0; i<n; i++) emit(v[i].c_str(), v[i].getSize());
+        return end_section();
+    }
+
+    template<typename T>
+    size_t write(const vector<vector<T>>& v) {
+        static_assert(std::is_trivially_copyable_v<T>, "flat arrays hold trivially copyable elements");
+        static_assert(alignof(T) <= 16, "nested element over-aligned for flat layout");
+        size_t n = v.getSize();
+        begin_section(flat_kind::nested, uint32_t(sizeof(T)));
+        emit_u64(n);
+        uint64_t pos = 0;
+        emit_u64(pos);
+        for (size_t i=0; i<n; i++) emit_u64(pos += v[i].getSize());
+        pad_to(16);
+        for (size_t i=0; i<n; i++) {
+            if (v[i].getSize()) emit(&v[i][0], v[i].getSize() * sizeof(T));
+        }
+        return end_section();
+    }
+
+    // Table + trailer; returns the total file size
+    size_t finish() {
+        if (finished) return offset;
+        pad_to(flat_alignment);
+        uint64_t table_offset = offset;
+        if (!table.empty()) emit(table.data(), table.size() * sizeof(flat_section));
+
+        flat_trailer t{};
+        t.table_offset = table_offset;
+        t.section_count = table.size();
+        t.checksum = crc;
+        std::memcpy(t.magic, "FLATEND", 8);
+        finished = true;
+        if (std::fwrite(&t, 1, sizeof(t), out) != sizeof(t)) throw std::runtime_error("flat_writer: write failed");
+        offset += sizeof(t);
+        if (std::fflush(out) != 0) throw std::runtime_error("flat_writer: flush failed");
+        return offset;
+    }
+};
+
+// Reader over a complete serialized buffer (usually a mapped_file)
+// - throws std::runtime_error for a malformed, foreign-endian, newer-version
+//   or (verify_checksum) corrupted buffer
+// - typed accessors throw std::invalid_argument on a kind/element-size mismatch
+//   or a buffer not aligned for T
+class flat_reader {
+private:
+    const unsigned char* base;
+    size_t length;
+    const flat_section* table;
+    size_t count;
+
+    static void fail(const char* what) { throw std::runtime_error(what); }
+
+    const flat_section& section(size_t i, flat_kind kind, uint32_t elem_size) const {
+        if (i >= count) throw std::out_of_range("flat_reader: no such section");
+        const flat_section& s = table[i];
+        if (s.kind != kind || s.elem_size != elem_size) {
+            throw std::invalid_argument("flat_reader: section type mismatch");
+        }
+        return s;
+    }
+
+    // count + offsets[count+1] header shared by str_list and nested
+    const uint64_t* offsets_of(const flat_section& s, uint64_t& n, size_t& header) const {
+        if (s.size < 16) fail("flat_reader: truncated section");
+        if (s.offset % alignof(uint64_t) != 0) fail("flat_reader: misaligned section");
+        const uint64_t* words = reinterpret_cast<const uint64_t*>(base + s.offset);
+        n = words[0];
+        if (n > (s.size - 16) / 8) fail("flat_reader: truncated section");
+        header = size_t(8 * (n + 2));
+        return words + 1;
+    }
+
+    // offsets index the section data: they must not decrease or run past it
+    // (checked once here, so element access stays unchecked)
+    static void check_offsets(const uint64_t* offs, uint64_t n, uint64_t limit) {
+        if (offs[n] > limit) fail("flat_reader: truncated section");
+        for (uint64_t i=0; i<n; i++) {
+            if (offs[i] > offs[i + 1]) fail("flat_reader: corrupt offsets");
+        }
+    }
+
+public:
+    flat_reader(const void* data, size_t size, bool verify_checksum = true)
+        : base(static_cast<const unsigned char*>(data)), length(size) {
+        if (length < sizeof(flat_header) + sizeof(flat_trailer)) fail("flat_reader: buffer too small");
+        if (reinterpret_cast<uintptr_t>(base) % alignof(uint64_t) != 0) {
+            throw std::invalid_argument("flat_reader: buffer not 8-byte aligned");
+        }
+
+        flat_header h;
+        std::memcpy(&h, base, sizeof(h));
+        if (std::memcmp(h.magic, "FLATSER", 8) != 0) fail("flat_reader: bad magic");
+        if (h.endian != 0x0102) fail("flat_reader: written with a different byte order");
+        if (h.version > flat_format_version) fail("flat_reader: unsupported format version");
+
+        flat_trailer t;
+        size_t trailer_at = length - sizeof(t);
+        std::memcpy(&t, base + trailer_at, sizeof(t));
+        if (std::memcmp(t.magic, "FLATEND", 8) != 0) fail("flat_reader: bad trailer");
+        if (t.table_offset > trailer_at || t.table_offset % alignof(flat_section) != 0 ||
+            t.section_count > (trailer_at - t.table_offset) / sizeof(flat_section)) {
+            fail("flat_reader: bad section table");
+        }
+        if (verify_checksum && crc32c(0, base, trailer_at) != t.checksum) fail("flat_reader: checksum mismatch");
+
+        table = reinterpret_cast<const flat_section*>(base + t.table_offset);
+        count = size_t(t.section_count);
+        for (size_t i=0; i<count; i++) {
+            if (table[i].offset > t.table_offset || table[i].size > t.table_offset - table[i].offset) {
+                fail("flat_reader: section out of bounds");
+            }
+        }
+    }
+
+    size_t section_count() const noexcept { return count; }
+    flat_kind kind(size_t i) const {
+        if (i >= count) throw std::out_of_range("flat_reader: no such section");
+        return table[i].kind;
+    }
+
+    template<typename T>
+    flat_span<T> array(size_t i) const {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const flat_section& s = section(i, flat_kind::array, uint32_t(sizeof(T)));
+        const unsigned char* p = base + s.offset;
+        if (reinterpret_cast<uintptr_t>(p) % alignof(T) != 0) {
+            throw std::invalid_argument("flat_reader: buffer not aligned for element type");
+        }
+        return flat_span<T>(reinterpret_cast<const T*>(p), size_t(s.size / sizeof(T)));
+    }
+
+    // NUL-terminated in the buffer, so data() can be passed to C APIs
+    // (the terminator sits before the section table, so it is in bounds)
+    std::string_view str(size_t i) const {
+        const flat_section& s = section(i, flat_kind::str, 1);
+        if (base[s.offset + s.size] != '\0') fail("flat_reader: string not terminated");
+        return std::string_view(reinterpret_cast<const char*>(base + s.offset), size_t(s.size));
+    }
+
+    flat_string_list strings(size_t i) const {
+        const flat_section& s = section(i, flat_kind::str_list, 1);
+        uint64_t n;
+        size_t header;
+        const uint64_t* offs = offsets_of(s, n, header);
+        check_offsets(offs, n, s.size - header);
+        return flat_string_list(offs, reinterpret_cast<const char*>(base + s.offset + header), size_t(n));
+    }
+
+    template<typename T>
+    flat_nested<T> nested(size_t i) const {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const flat_section& s = section(i, flat_kind::nested, uint32_t(sizeof(T)));
+        uint64_t n;
+        size_t header;
+        const uint64_t* offs = offsets_of(s, n, header);
+        header = (header + 15) & ~size_t(15);
+        if (header > s.size) fail("flat_reader: truncated section");
+        check_offsets(offs, n, (s.size - header) / sizeof(T));
+        const unsigned char* p = base + s.offset + header;
+        if (reinterpret_cast<uintptr_t>(p) % alignof(T) != 0) {
+            throw std::invalid_argument("flat_reader: buffer not aligned for element type");
+        }
+        return flat_nested<T>(offs, reinterpret_cast<const T*>(p), size_t(n));
+    }
+};
+
+// Read-only mmap of a whole file; the mapping is released by a unique_ptr deleter
+class mapped_file {
+private:
+    struct munmap_deleter {
+        size_t length = 0;
+        void operator()(const unsigned char* p) const noexcept {
+            ::munmap(const_cast<unsigned char*>(p), length);
+        }
+    };
+
+    unique_ptr<const unsigned char, munmap_deleter> mapping;
+    size_t length = 0;
+
+public:
+    explicit mapped_file(const char* path) {
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "mapped_file: open");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "mapped_file: stat");
+        }
+        if (st.st_size == 0) {
+            ::close(fd);
+            throw std::system_error(EINVAL, std::generic_category(), "mapped_file: empty file");
+        }
+        length = size_t(st.st_size);
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        int err = errno;            // close() may overwrite it
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::system_error(err, std::generic_category(), "mapped_file: mmap");
+        mapping = unique_ptr<const unsigned char, munmap_deleter>(
+            static_cast<const unsigned char*>(p), munmap_deleter{length});
+    }
+
+    const unsigned char* data() const noexcept { return mapping.get(); }
+    size_t size() const noexcept { return length; }
+
+    flat_reader reader(bool verify_checksum = true) const {
+        return flat_reader(data(), size(), verify_checksum);
+    }
+};
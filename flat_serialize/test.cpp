@@ -0,0 +1,241 @@
+#include "gtest/gtest.h"
+#include "flat_serialize.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+struct Point {
+    float x, y, z;
+    int id;
+};
+
+// temp file written through flat_writer, removed with the fixture
+class FlatSerializeTest : public ::testing::Test {
+protected:
+    char path[32] = "/tmp/flat_test_XXXXXX";
+    std::FILE* f = nullptr;
+
+    void SetUp() override {
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        f = fdopen(fd, "w+b");
+    }
+    void TearDown() override {
+        if (f) std::fclose(f);
+        std::remove(path);
+    }
+
+    std::string contents() {
+        std::fseek(f, 0, SEEK_END);
+        std::string s(size_t(std::ftell(f)), '\0');
+        std::rewind(f);
+        EXPECT_EQ(std::fread(s.data(), 1, s.size(), f), s.size());
+        return s;
+    }
+};
+
+TEST(Crc32cTest, KnownVector) {
+    EXPECT_EQ(crc32c(0, "123456789", 9), 0xE3069283u);
+    // incremental == one shot
+    EXPECT_EQ(crc32c(crc32c(0, "12345", 5), "6789", 4), 0xE3069283u);
+}
+
+TEST_F(FlatSerializeTest, RoundTripThroughMmap) {
+    vector<int> ints;
+    for (int i=0; i<1000; i++) ints.push_back(i * 3);
+    vector<Point> points;
+    points.push_back({1, 2, 3, 7});
+    points.push_back({4, 5, 6, 8});
+    vector<string> names;
+    names.push_back("alpha");
+    names.push_back("");
+    names.push_back("gamma delta");
+    vector<vector<double>> rows;
+    for (int r=0; r<4; r++) {
+        vector<double> row;
+        for (int c=0; c<r; c++) row.push_back(r + c / 10.0);
+        rows.push_back(std::move(row));
+    }
+
+    {
+        flat_writer w(f);
+        EXPECT_EQ(w.write(ints), 0);
+        EXPECT_EQ(w.write(points), 1);
+        EXPECT_EQ(w.write(string("hello flat")), 2);
+        EXPECT_EQ(w.write(names), 3);
+        EXPECT_EQ(w.write(rows), 4);
+        w.finish();
+    }
+
+    mapped_file file(path);
+    EXPECT_EQ(file.size() % 8, 0);
+    flat_reader r = file.reader();
+    ASSERT_EQ(r.section_count(), 5);
+
+    auto is = r.array<int>(0);
+    ASSERT_EQ(is.size(), 1000);
+    EXPECT_EQ(is[999], 2997);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(is.data()) % flat_alignment, 0);   // zero copy, aligned
+    EXPECT_GE(reinterpret_cast<const unsigned char*>(is.data()), file.data());
+
+    auto ps = r.array<Point>(1);
+    ASSERT_EQ(ps.size(), 2);
+    EXPECT_EQ(ps[1].id, 8);
+    EXPECT_FLOAT_EQ(ps[1].z, 6);
+
+    EXPECT_EQ(r.str(2), "hello flat");
+    EXPECT_EQ(r.str(2).data()[r.str(2).size()], '\0');
+
+    auto ns = r.strings(3);
+    ASSERT_EQ(ns.size(), 3);
+    EXPECT_EQ(ns[0], "alpha");
+    EXPECT_EQ(ns[1], "");
+    EXPECT_EQ(ns[2], "gamma delta");
+
+    auto rs = r.nested<double>(4);
+    ASSERT_EQ(rs.size(), 4);
+    EXPECT_TRUE(rs[0].empty());
+    ASSERT_EQ(rs[3].size(), 3);
+    EXPECT_DOUBLE_EQ(rs[3][2], 3.2);
+    EXPECT_EQ(r.kind(4), flat_kind::nested);
+}
+
+TEST_F(FlatSerializeTest, EmptyContainers) {
+    {
+        flat_writer w(f);
+        w.write(vector<int>());
+        w.write(vector<string>());
+        w.write(vector<vector<int>>());
+        w.write(string(""));
+    }
+    std::string buf = contents();
+    flat_reader r(buf.data(), buf.size());
+    EXPECT_TRUE(r.array<int>(0).empty());
+    EXPECT_TRUE(r.strings(1).empty());
+    EXPECT_TRUE(r.nested<int>(2).empty());
+    EXPECT_EQ(r.str(3), "");
+}
+
+TEST_F(FlatSerializeTest, TypeMismatchThrows) {
+    {
+        flat_writer w(f);
+        vector<int> v;
+        v.push_back(1);
+        w.write(v);
+    }
+    mapped_file file(path);
+    flat_reader r = file.reader();
+    EXPECT_THROW(r.array<double>(0), std::invalid_argument);    // element size differs
+    EXPECT_THROW(r.strings(0), std::invalid_argument);
+    EXPECT_THROW(r.array<int>(1), std::out_of_range);
+    EXPECT_EQ(r.array<unsigned>(0)[0], 1u);                     // same size is accepted
+}
+
+TEST_F(FlatSerializeTest, CorruptionDetected) {
+    {
+        flat_writer w(f);
+        w.write(string("payload that will be damaged"));
+    }
+    std::string buf = contents();
+    alignas(8) char copy[4096];
+    ASSERT_LE(buf.size(), sizeof(copy));
+
+    std::memcpy(copy, buf.data(), buf.size());
+    copy[flat_alignment + 3] ^= 0x20;                           // flip a payload bit
+    EXPECT_THROW(flat_reader(copy, buf.size()), std::runtime_error);
+    EXPECT_NO_THROW(flat_reader(copy, buf.size(), false));      // verification is optional
+
+    std::memcpy(copy, buf.data(), buf.size());
+    EXPECT_THROW(flat_reader(copy, buf.size() - 8), std::runtime_error);   // truncated
+
+    std::memcpy(copy, buf.data(), buf.size());
+    copy[flat_alignment + std::strlen("payload that will be damaged")] = 'x';   // the terminator
+    EXPECT_THROW(flat_reader(copy, buf.size(), false).str(0), std::runtime_error);
+
+    std::memcpy(copy, buf.data(), buf.size());
+    uint16_t newer = flat_format_version + 1;
+    std::memcpy(copy + 8, &newer, sizeof(newer));
+    EXPECT_THROW(flat_reader(copy, buf.size(), false), std::runtime_error);
+}
+
+TEST_F(FlatSerializeTest, CorruptOffsetsRejected) {
+    vector<string> names;
+    names.push_back("alpha");
+    names.push_back("beta");
+    vector<vector<int>> rows;
+    for (int r=0; r<3; r++) {
+        vector<int> row;
+        for (int c=0; c<=r; c++) row.push_back(c);
+        rows.push_back(std::move(row));
+    }
+    {
+        flat_writer w(f);
+        w.write(names);
+        w.write(rows);
+    }
+    std::string buf = contents();
+    alignas(8) char copy[4096];
+    ASSERT_LE(buf.size(), sizeof(copy));
+
+    // offsets[] of section i: after its count word
+    auto offsets = [&](size_t i) {
+        flat_trailer t;
+        std::memcpy(&t, copy + buf.size() - sizeof(t), sizeof(t));
+        flat_section s;
+        std::memcpy(&s, copy + t.table_offset + i * sizeof(s), sizeof(s));
+        return reinterpret_cast<uint64_t*>(copy + s.offset) + 1;
+    };
+
+    // a middle offset past the end: only offsets[n] used to be checked
+    std::memcpy(copy, buf.data(), buf.size());
+    offsets(0)[1] = 1000;
+    EXPECT_THROW(flat_reader(copy, buf.size(), false).strings(0), std::runtime_error);
+
+    // decreasing offsets would give a negative length
+    std::memcpy(copy, buf.data(), buf.size());
+    offsets(1)[2] = 0;
+    EXPECT_THROW(flat_reader(copy, buf.size(), false).nested<int>(1), std::runtime_error);
+
+    std::memcpy(copy, buf.data(), buf.size());
+    EXPECT_EQ(flat_reader(copy, buf.size(), false).nested<int>(1)[2][2], 2);
+
+    // section table not 8-byte aligned
+    std::memcpy(copy, buf.data(), buf.size());
+    uint64_t table_offset;
+    std::memcpy(&table_offset, copy + buf.size() - sizeof(flat_trailer), 8);
+    table_offset -= 4;
+    std::memcpy(copy + buf.size() - sizeof(flat_trailer), &table_offset, 8);
+    EXPECT_THROW(flat_reader(copy, buf.size(), false), std::runtime_error);
+}
+
+TEST_F(FlatSerializeTest, StreamsManySections) {
+    {
+        flat_writer w(f);
+        for (int i=0; i<500; i++) {
+            vector<int> chunk;
+            for (int j=0; j<i; j++) chunk.push_back(i);
+            w.write(chunk);
+        }
+        // the writer does not hold section payloads: bytes already reached the FILE
+        EXPECT_GT(std::ftell(f), long(500 * 499 / 2 * sizeof(int)));
+    }
+    mapped_file file(path);
+    flat_reader r = file.reader();
+    ASSERT_EQ(r.section_count(), 500);
+    for (size_t i=0; i<500; i++) {
+        auto s = r.array<int>(i);
+        ASSERT_EQ(s.size(), i);
+        if (i) {
+            EXPECT_EQ(s[i - 1], int(i));
+        }
+    }
+}
+
+TEST(MappedFileTest, MissingFileThrows) {
+    EXPECT_THROW(mapped_file("/nonexistent/flat.bin"), std::system_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
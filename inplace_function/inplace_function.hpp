@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename Signature, size_t Capacity = 64, size_t Alignment = alignof(std::max_align_t)>
+class inplace_function;
+
+// Move-only type-erased callable stored entirely inline
+// - no heap fallback: a callable larger than Capacity is a compile error
+// - move-only targets (e.g. lambdas capturing unique_ptr) are allowed,
+//   unlike std::function which needs copyable targets
+// - one pointer to a static per-type vtable + Capacity bytes of storage
+template<typename R, typename... Args, size_t Capacity, size_t Alignment>
+class inplace_function<R(Args...), Capacity, Alignment> {
+private:
+    struct vtable {
+        R (*invoke)(void*, Args&&...);
+        void (*move)(void* dst, void* src) noexcept;   // move-construct into dst, destroy src
+        void (*destroy)(void*) noexcept;
+    };
+
+    template<typename F>
+    static constexpr vtable vtable_for = {
+        [](void* obj, Args&&... args) -> R {
+            return (*static_cast<F*>(obj))(std::forward<Args>(args)...);
+        },
+        [](void* dst, void* src) noexcept {
+            new (dst) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+        },
+        [](void* obj) noexcept {
+            static_cast<F*>(obj)->~F();
+        }
+    };
+
+    alignas(Alignment) unsigned char storage[Capacity];
+    const vtable* vt;
+
+public:
+    // true if F can be stored - for checks in generic code
+    template<typename F>
+    static constexpr bool fits = sizeof(F) <= Capacity && alignof(F) <= Alignment;
+
+    // Default Constructor - empty, calling it throws std::bad_function_call
+    inplace_function() noexcept : vt(nullptr) {}
+    inplace_function(std::nullptr_t) noexcept : vt(nullptr) {}
+
+    // Construct from any callable with a matching signature
+    template<typename F, typename D = std::decay_t<F>>
+        requires (!std::is_same_v<D, inplace_function>) && std::is_invocable_r_v<R, D&, Args...>
+    inplace_function(F&& f) : vt(&vtable_for<D>) {
+        static_assert(sizeof(D) <= Capacity, "callable too large for inplace_function storage");
+        static_assert(alignof(D) <= Alignment, "callable over-aligned for inplace_function storage");
+        static_assert(std::is_nothrow_move_constructible_v<D>, "callable must be nothrow movable");
+        new (storage) D(std::forward<F>(f));
+    }
+
+    // Delete Copy operations - targets may be move-only
+    inplace_function(const inplace_function&) = delete;
+    inplace_function& operator=(const inplace_function&) = delete;
+
+    // Move Constructor
+    inplace_function(inplace_function&& other) noexcept : vt(other.vt) {
+        if (vt) {
+            vt->move(storage, other.storage);
+            other.vt = nullptr;
+        }
+    }
+
+    // Move Assignment
+    inplace_function& operator=(inplace_function&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.vt) {
+                other.vt->move(storage, other.storage);
+                vt = other.vt;
+                other.vt = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    // Destructor
+    ~inplace_function() {
+        reset();
+    }
+
+    // Modifiers
+    void reset() noexcept {
+        if (vt) {
+            vt->destroy(storage);
+            vt = nullptr;
+        }
+    }
+
+    // Invoke
+    R operator()(Args... args) {
+        if (!vt) throw std::bad_function_call();
+        return vt->invoke(storage, std::forward<Args>(args)...);
+    }
+
+    // Observers
+    explicit operator bool() const noexcept {
+        return vt != nullptr;
+    }
+};
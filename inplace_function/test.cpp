@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include "inplace_function.hpp"
+#include "../unique_ptr/unique_ptr.hpp"
+#include "../shared_ptr/shared_ptr.hpp"
+
+TEST(InplaceFunctionTest, CallsTarget) {
+    inplace_function<int(int, int)> add = [](int a, int b) { return a + b; };
+    EXPECT_TRUE(add);
+    EXPECT_EQ(add(2, 3), 5);
+}
+
+TEST(InplaceFunctionTest, EmptyThrows) {
+    inplace_function<void()> f;
+    EXPECT_FALSE(f);
+    EXPECT_THROW(f(), std::bad_function_call);
+}
+
+TEST(InplaceFunctionTest, MoveOnlyCaptureWithUniquePtr) {
+    auto owned = make_unique<int>(42);
+    inplace_function<int()> task = [p = std::move(owned)] { return *p; };
+    EXPECT_FALSE(owned);
+    EXPECT_EQ(task(), 42);
+
+    inplace_function<int()> moved = std::move(task);
+    EXPECT_FALSE(task);
+    EXPECT_EQ(moved(), 42);
+}
+
+TEST(InplaceFunctionTest, SharedPtrCaptureReleasedOnDestroy) {
+    auto shared = make_shared<int>(7);
+    {
+        inplace_function<int()> task = [shared] { return *shared; };
+        EXPECT_EQ(shared.use_count(), 2);
+        EXPECT_EQ(task(), 7);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(InplaceFunctionTest, MoveAssignmentDestroysOldTarget) {
+    auto a = make_shared<int>(1);
+    auto b = make_shared<int>(2);
+    inplace_function<int()> f = [a] { return *a; };
+    f = inplace_function<int()>([b] { return *b; });
+    EXPECT_EQ(a.use_count(), 1);
+    EXPECT_EQ(f(), 2);
+
+    f.reset();
+    EXPECT_EQ(b.use_count(), 1);
+}
+
+TEST(InplaceFunctionTest, ArgumentsAreForwarded) {
+    inplace_function<int(unique_ptr<int>)> take = [](unique_ptr<int> p) { return *p; };
+    EXPECT_EQ(take(make_unique<int>(9)), 9);
+}
+
+TEST(InplaceFunctionTest, CapacityIsCompileTime) {
+    struct Big { char bytes[128]; int operator()() const { return 0; } };
+    using small_fn = inplace_function<int(), 32>;
+    // constructing small_fn from Big fails to compile; fits<> lets generic code check first
+    static_assert(!small_fn::fits<Big>);
+    static_assert(inplace_function<int(), 128>::fits<Big>);
+    EXPECT_EQ(sizeof(small_fn), 32 + alignof(std::max_align_t));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
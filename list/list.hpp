@@ -2,12 +2,13 @@
 #include <cstddef>
 #include <utility>
 #include <stdexcept>
+#include "../alloc_tracker/alloc_tracker.hpp"
 
 template<typename T>
 class list {
 private:
-    // stored on heap
-    struct Node {
+    // stored on heap - new/delete go through alloc_tracker
+    struct Node : tracked_new<alloc_kind::list> {
         T value;
         Node* next;
         Node* prev;
@@ -30,12 +31,19 @@ public:
         T& operator*() { return ptr->value; }
         iterator& operator++() { ptr = ptr->next; return *this; }
         iterator& operator--() { ptr = ptr->prev; return *this; }
+        bool operator==(const iterator& other) const { return ptr == other.ptr; }
         bool operator!=(const iterator& other) const { return ptr != other.ptr; }
     };
 
     iterator begin() { return iterator(head); }
     iterator end() { return iterator(nullptr); }
 
+    // Element access
+    T& front() { return head->value; }
+    const T& front() const { return head->value; }
+    T& back() { return tail->value; }
+    const T& back() const { return tail->value; }
+
     // Capacity
     size_t size() const { return sz; }
     bool empty() const { return sz == 0; }
@@ -114,6 +122,29 @@ public:
         return ret;
     }
 
+    // Splice - relink node `it` of `other` before `pos`, no allocation or copy
+    // iterators to the moved node stay valid
+    void splice(iterator pos, list& other, iterator it) {
+        Node* node = it.ptr;
+        if (node == nullptr || node == pos.ptr) return;
+
+        // unlink from other
+        if (node->prev) node->prev->next = node->next;
+        else other.head = node->next;
+        if (node->next) node->next->prev = node->prev;
+        else other.tail = node->prev;
+        --other.sz;
+
+        // link before pos (end() appends)
+        node->next = pos.ptr;
+        node->prev = pos.ptr ? pos.ptr->prev : tail;
+        if (node->prev) node->prev->next = node;
+        else head = node;
+        if (pos.ptr) pos.ptr->prev = node;
+        else tail = node;
+        ++sz;
+    }
+
     void clear() {
         Node* curr = head;
         while (curr) {
@@ -0,0 +1,63 @@
+// Multi-threaded get-or-put benchmark over Zipfian keys
+// g++ -std=c++20 -O2 -pthread bench.cpp -o bench && ./bench
+#include "lru_cache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Zipf(s) over [0, n) by inverse CDF lookup
+struct zipf {
+    std::vector<double> cdf;
+
+    zipf(size_t n, double s) : cdf(n) {
+        double sum = 0;
+        for (size_t i=0; i<n; i++) {
+            sum += 1.0 / std::pow(double(i + 1), s);
+            cdf[i] = sum;
+        }
+        for (double& c : cdf) c /= sum;
+    }
+
+    size_t operator()(std::mt19937_64& rng) const {
+        double u = std::uniform_real_distribution<double>(0, 1)(rng);
+        size_t i = std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+        return std::min(i, cdf.size() - 1);
+    }
+};
+
+int main() {
+    const size_t keys = 1 << 20;
+    const size_t capacity = 1 << 16;
+    const size_t ops_per_thread = 1 << 20;
+    zipf dist(keys, 0.99);
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t shards : {1, 16, 64}) {
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            lru_cache<size_t, size_t> cache(capacity, shards);
+            std::vector<std::thread> pool;
+
+            auto start = std::chrono::steady_clock::now();
+            for (unsigned t=0; t<threads; t++) {
+                pool.emplace_back([&, t] {
+                    std::mt19937_64 rng(t + 1);
+                    for (size_t i=0; i<ops_per_thread; i++) {
+                        size_t key = dist(rng);
+                        if (!cache.get(key)) cache.put(key, make_shared<size_t>(key));
+                    }
+                });
+            }
+            for (auto& th : pool) th.join();
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            auto s = cache.get_stats();
+            std::printf("shards=%-3zu threads=%-2u  %7.2f Mops/s  hit=%.3f  evictions=%zu\n",
+                shards, threads, threads * ops_per_thread / secs / 1e6,
+                double(s.hits) / double(s.hits + s.misses), s.evictions);
+        }
+    }
+}
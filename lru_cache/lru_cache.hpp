@@ -0,0 +1,157 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include "../list/list.hpp"
+#include "../shared_ptr/shared_ptr.hpp"
+
+// Sharded LRU cache
+// - each shard = own mutex + recency list (front = most recent) + hash index
+// - values held as shared_ptr so readers keep entries alive after eviction
+// - capacity is in "charge" units: charge 1 per entry = entry count,
+//   charge = bytes per entry = byte budget
+template<typename K, typename V, typename Hash = std::hash<K>>
+class lru_cache {
+public:
+    struct stats {
+        size_t hits;
+        size_t misses;
+        size_t evictions;
+        size_t entries;
+        size_t charge;
+    };
+
+private:
+    struct Entry {
+        K key;
+        shared_ptr<V> value;
+        size_t charge;
+    };
+
+    using iter = typename list<Entry>::iterator;
+
+    struct Shard {
+        std::mutex mtx;
+        list<Entry> order;
+        std::unordered_map<K, iter, Hash> index;
+        size_t capacity = 0;
+        size_t usage = 0;
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+
+        // drop least recently used entries until usage fits
+        void evict() {
+            while (usage > capacity && !order.empty()) {
+                Entry& victim = order.back();
+                usage -= victim.charge;
+                index.erase(victim.key);
+                order.pop_back();
+                ++evictions;
+            }
+        }
+    };
+
+    Shard* shards;
+    size_t num_shards;
+    Hash hasher;
+
+    Shard& shard_for(const K& key) {
+        return shards[hasher(key) % num_shards];
+    }
+
+public:
+    // Constructor - capacity split evenly across shards
+    // no more shards than capacity, so every shard can hold at least one entry
+    explicit lru_cache(size_t capacity, size_t shard_count = 16)
+        : num_shards(std::max<size_t>(1, std::min(shard_count, capacity))) {
+        shards = new Shard[num_shards];
+        for (size_t i=0; i<num_shards; i++) {
+            shards[i].capacity = capacity / num_shards;
+            if (i < capacity % num_shards) shards[i].capacity++;
+        }
+    }
+
+    ~lru_cache() {
+        delete[] shards;
+    }
+
+    // Delete Copy operations - shards own mutexes
+    lru_cache(const lru_cache&) = delete;
+    lru_cache& operator=(const lru_cache&) = delete;
+
+    // Lookup - hit moves entry to front
+    shared_ptr<V> get(const K& key) {
+        Shard& s = shard_for(key);
+        std::lock_guard<std::mutex> lock(s.mtx);
+        auto found = s.index.find(key);
+        if (found == s.index.end()) {
+            ++s.misses;
+            return shared_ptr<V>();
+        }
+        ++s.hits;
+        s.order.splice(s.order.begin(), s.order, found->second);
+        return (*found->second).value;
+    }
+
+    // Insert or replace, then evict down to capacity
+    // an entry larger than its shard is not cached (it would evict the whole
+    // shard, then itself); an older value under the same key is dropped
+    void put(const K& key, shared_ptr<V> value, size_t charge = 1) {
+        Shard& s = shard_for(key);
+        std::lock_guard<std::mutex> lock(s.mtx);
+        auto found = s.index.find(key);
+        if (charge > s.capacity) {
+            if (found != s.index.end()) {
+                s.usage -= (*found->second).charge;
+                s.order.erase(found->second);
+                s.index.erase(found);
+            }
+            return;
+        }
+        if (found != s.index.end()) {
+            Entry& e = *found->second;
+            s.usage = s.usage - e.charge + charge;
+            e.value = std::move(value);
+            e.charge = charge;
+            s.order.splice(s.order.begin(), s.order, found->second);
+        } else {
+            s.order.push_front(Entry{key, std::move(value), charge});
+            s.index.emplace(key, s.order.begin());
+            s.usage += charge;
+        }
+        s.evict();
+    }
+
+    bool erase(const K& key) {
+        Shard& s = shard_for(key);
+        std::lock_guard<std::mutex> lock(s.mtx);
+        auto found = s.index.find(key);
+        if (found == s.index.end()) return false;
+        s.usage -= (*found->second).charge;
+        s.order.erase(found->second);
+        s.index.erase(found);
+        return true;
+    }
+
+    // Observers - summed over shards, each shard read under its own lock
+    stats get_stats() {
+        stats total{0, 0, 0, 0, 0};
+        for (size_t i=0; i<num_shards; i++) {
+            std::lock_guard<std::mutex> lock(shards[i].mtx);
+            total.hits += shards[i].hits;
+            total.misses += shards[i].misses;
+            total.evictions += shards[i].evictions;
+            total.entries += shards[i].order.size();
+            total.charge += shards[i].usage;
+        }
+        return total;
+    }
+
+    size_t size() {
+        return get_stats().entries;
+    }
+};
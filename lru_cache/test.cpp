@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+#include "lru_cache.hpp"
+#include <thread>
+#include <vector>
+
+// single shard so eviction order is deterministic
+TEST(LruCacheTest, GetAndPut) {
+    lru_cache<int, int> cache(2, 1);
+    cache.put(1, make_shared<int>(10));
+    cache.put(2, make_shared<int>(20));
+
+    auto v = cache.get(1);
+    EXPECT_TRUE(v);
+    EXPECT_EQ(*v, 10);
+    EXPECT_FALSE(cache.get(3));
+
+    auto s = cache.get_stats();
+    EXPECT_EQ(s.hits, 1);
+    EXPECT_EQ(s.misses, 1);
+    EXPECT_EQ(s.entries, 2);
+}
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+    lru_cache<int, int> cache(2, 1);
+    cache.put(1, make_shared<int>(10));
+    cache.put(2, make_shared<int>(20));
+    cache.get(1);                       // 2 is now least recent
+    cache.put(3, make_shared<int>(30));
+
+    EXPECT_TRUE(cache.get(1));
+    EXPECT_FALSE(cache.get(2));
+    EXPECT_TRUE(cache.get(3));
+    EXPECT_EQ(cache.get_stats().evictions, 1);
+}
+
+TEST(LruCacheTest, ReplaceExistingKey) {
+    lru_cache<int, int> cache(2, 1);
+    cache.put(1, make_shared<int>(10));
+    cache.put(1, make_shared<int>(11));
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(*cache.get(1), 11);
+}
+
+TEST(LruCacheTest, ByteCapacity) {
+    lru_cache<int, int> cache(100, 1);
+    cache.put(1, make_shared<int>(1), 60);
+    cache.put(2, make_shared<int>(2), 30);
+    cache.put(3, make_shared<int>(3), 30);   // 120 > 100, evicts key 1
+
+    EXPECT_FALSE(cache.get(1));
+    EXPECT_EQ(cache.get_stats().charge, 60);
+}
+
+TEST(LruCacheTest, OversizedEntryIsNotCached) {
+    lru_cache<int, int> cache(100, 1);
+    cache.put(1, make_shared<int>(1), 30);
+    cache.put(2, make_shared<int>(2), 30);
+    cache.put(3, make_shared<int>(3), 150);  // larger than the shard: others stay
+    EXPECT_FALSE(cache.get(3));
+    EXPECT_TRUE(cache.get(1));
+    EXPECT_TRUE(cache.get(2));
+    EXPECT_EQ(cache.get_stats().evictions, 0);
+
+    cache.put(1, make_shared<int>(10), 150); // no stale value left behind
+    EXPECT_FALSE(cache.get(1));
+    EXPECT_EQ(cache.get_stats().charge, 30);
+}
+
+TEST(LruCacheTest, ValueOutlivesEviction) {
+    lru_cache<int, int> cache(1, 1);
+    cache.put(1, make_shared<int>(10));
+    auto held = cache.get(1);
+    cache.put(2, make_shared<int>(20));
+
+    EXPECT_FALSE(cache.get(1));
+    EXPECT_EQ(*held, 10);
+    EXPECT_EQ(held.use_count(), 1);
+}
+
+TEST(LruCacheTest, SmallCapacityHoldsEveryEntry) {
+    // fewer entries than the default 16 shards: no shard may end up with capacity 0
+    lru_cache<int, int> cache(4);
+    for (int i=0; i<4; i++) cache.put(i, make_shared<int>(i));
+    EXPECT_EQ(cache.size(), 4);
+    for (int i=0; i<4; i++) EXPECT_TRUE(cache.get(i));
+    EXPECT_EQ(cache.get_stats().evictions, 0);
+}
+
+TEST(LruCacheTest, Erase) {
+    lru_cache<int, int> cache(4);
+    cache.put(1, make_shared<int>(10));
+    EXPECT_TRUE(cache.erase(1));
+    EXPECT_FALSE(cache.erase(1));
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(LruCacheTest, ConcurrentPutGet) {
+    lru_cache<int, int> cache(64, 8);
+    std::vector<std::thread> threads;
+    for (int t=0; t<4; t++) {
+        threads.emplace_back([&cache, t] {
+            for (int i=0; i<1000; i++) {
+                int key = (i * 7 + t) % 128;
+                if (!cache.get(key)) cache.put(key, make_shared<int>(key));
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    auto s = cache.get_stats();
+    EXPECT_EQ(s.hits + s.misses, 4000);
+    EXPECT_LE(s.entries, 64);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,48 @@
+// Multi-threaded acquire/release churn: object_pool vs new/delete
+// g++ -std=c++20 -O2 -pthread bench.cpp -o bench && ./bench
+#include "object_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+struct Message {
+    long id;
+    char body[120];
+    explicit Message(long i) : id(i) {}
+};
+
+// each thread keeps a sliding window of live messages, so frees lag allocations
+template<typename Make>
+double churn_mops(unsigned threads, size_t ops, Make make) {
+    std::vector<std::thread> pool;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t=0; t<threads; t++) {
+        pool.emplace_back([&] {
+            using H = decltype(make(0));
+            std::vector<H> window(64);
+            for (size_t i=0; i<ops; i++) {
+                window[i % window.size()] = make(long(i));
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return threads * ops / secs / 1e6;
+}
+
+int main() {
+    const size_t ops = 5'000'000;
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        double heap = churn_mops(threads, ops, [](long i) { return make_unique<Message>(i); });
+
+        object_pool<Message> msgs;
+        double pooled = churn_mops(threads, ops, [&](long i) { return msgs.acquire(i); });
+
+        auto s = msgs.get_stats();
+        std::printf("threads=%-2u  new/delete %7.2f Mops/s  pool %7.2f Mops/s  hit=%.4f high_water=%zu\n",
+            threads, heap, pooled, s.hit_rate(), s.high_water);
+    }
+}
@@ -0,0 +1,196 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+#include "../unique_ptr/unique_ptr.hpp"
+#include "../reclaim/retired.hpp"
+
+// Typed object pool handing out unique_ptr<T, pool_deleter>
+// - destroying the handle returns the slot to the pool instead of calling delete
+// - each thread keeps its own free list (no locking on the hot path);
+//   surplus slots spill in batches to a mutex-guarded global list, and an
+//   empty thread list refills from it before allocating
+// - reset mode: on release, call reset(T&) and keep the object constructed,
+//   so acquire() with no args reuses it without running constructors
+// - the pool must outlive every handle it gave out
+template<typename T>
+class object_pool {
+public:
+    using reset_fn = void (*)(T&);
+
+    struct stats {
+        size_t acquires;
+        size_t hits;            // served from a free list
+        size_t high_water;      // most objects out at once
+        double hit_rate() const { return acquires ? double(hits) / double(acquires) : 0; }
+    };
+
+    // Deleter - returns the object to its pool
+    struct pool_deleter {
+        object_pool* pool = nullptr;
+        void operator()(T* p) const noexcept { pool->recycle(p); }
+    };
+
+    using handle = unique_ptr<T, pool_deleter>;
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        Slot* next;
+        bool constructed;       // reset mode keeps recycled objects alive
+    };
+
+    static constexpr size_t local_limit = 128;
+    static constexpr size_t batch = 64;
+
+    // per-thread free list; counters have a single writer, read by get_stats()
+    struct Record {
+        std::atomic<unsigned> refs{0};
+        Record* next = nullptr;
+        Slot* free_head = nullptr;
+        size_t free_count = 0;
+        std::atomic<size_t> acquires{0};
+        std::atomic<size_t> hits{0};
+    };
+
+    reset_fn reset;
+    record_registry<Record> registry;
+    uint64_t id = next_domain_id();
+
+    std::mutex global_mtx;
+    Slot* global_head = nullptr;
+    size_t global_count = 0;
+    std::atomic<size_t> live{0};            // objects handed out and not yet returned
+    std::atomic<size_t> peak{0};
+
+    friend class thread_records<object_pool, Record>;
+
+    Record* local() { return thread_records<object_pool, Record>::get(this); }
+
+    static void bump(std::atomic<size_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Slot* take_slot(Record* r) {
+        if (!r->free_head) {
+            std::lock_guard<std::mutex> lock(global_mtx);
+            for (size_t i=0; i<batch && global_head; i++) {
+                Slot* s = global_head;
+                global_head = s->next;
+                global_count--;
+                s->next = r->free_head;
+                r->free_head = s;
+                r->free_count++;
+            }
+        }
+        if (Slot* s = r->free_head) {
+            r->free_head = s->next;
+            r->free_count--;
+            bump(r->hits);
+            return s;
+        }
+        Slot* s = static_cast<Slot*>(operator new(sizeof(Slot)));
+        s->constructed = false;
+        return s;
+    }
+
+    // one more object out; raise the peak only when it is exceeded
+    handle hand_out(T* p) {
+        size_t now = live.fetch_add(1, std::memory_order_relaxed) + 1;
+        size_t seen = peak.load(std::memory_order_relaxed);
+        while (now > seen && !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {}
+        return handle(p, pool_deleter{this});
+    }
+
+    void recycle(T* p) noexcept {
+        live.fetch_sub(1, std::memory_order_relaxed);
+        Slot* s = reinterpret_cast<Slot*>(p);
+        if (reset) {
+            reset(*p);
+            s->constructed = true;
+        } else {
+            p->~T();
+            s->constructed = false;
+        }
+
+        Record* r = local();
+        s->next = r->free_head;
+        r->free_head = s;
+        r->free_count++;
+
+        // spill a batch so one thread's frees don't hoard memory
+        if (r->free_count > local_limit) {
+            std::lock_guard<std::mutex> lock(global_mtx);
+            for (size_t i=0; i<batch; i++) {
+                Slot* moved = r->free_head;
+                r->free_head = moved->next;
+                r->free_count--;
+                moved->next = global_head;
+                global_head = moved;
+                global_count++;
+            }
+        }
+    }
+
+    static void free_list(Slot* s) {
+        while (s) {
+            Slot* next = s->next;
+            if (s->constructed) reinterpret_cast<T*>(s->storage)->~T();
+            operator delete(s);
+            s = next;
+        }
+    }
+
+public:
+    // Constructor - reset != nullptr turns on reset-instead-of-destroy
+    explicit object_pool(reset_fn reset_mode = nullptr) : reset(reset_mode) {}
+
+    // every handle must have been returned
+    ~object_pool() {
+        thread_records<object_pool, Record>::forget(this);
+        for (Record* r = registry.first(); r; r = r->next) free_list(r->free_head);
+        free_list(global_head);
+    }
+
+    // Delete Copy operations - handles point back at the pool
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+
+    // Acquire - construct T(args...) in a pooled slot
+    // reset mode with no args: reuse a recycled object as is
+    template<typename... Args>
+    handle acquire(Args&&... args) {
+        Record* r = local();
+        bump(r->acquires);
+        Slot* s = take_slot(r);
+        T* p = reinterpret_cast<T*>(s->storage);
+
+        if (s->constructed) {
+            if constexpr (sizeof...(Args) == 0) return hand_out(p);
+            p->~T();
+            s->constructed = false;
+        }
+        try {
+            new (s->storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            s->next = r->free_head;
+            r->free_head = s;
+            r->free_count++;
+            throw;
+        }
+        s->constructed = true;
+        return hand_out(p);
+    }
+
+    // Observers - summed over per-thread records
+    stats get_stats() const {
+        stats total{0, 0, peak.load(std::memory_order_relaxed)};
+        for (Record* r = registry.first(); r; r = r->next) {
+            total.acquires += r->acquires.load(std::memory_order_relaxed);
+            total.hits += r->hits.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+};
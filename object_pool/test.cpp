@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+#include "object_pool.hpp"
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct Message {
+    static std::atomic<int> constructed;
+    static std::atomic<int> destroyed;
+    int id;
+    int payload[8];
+
+    explicit Message(int i = 0) : id(i) { ++constructed; }
+    ~Message() { ++destroyed; }
+};
+std::atomic<int> Message::constructed = 0;
+std::atomic<int> Message::destroyed = 0;
+
+TEST(ObjectPoolTest, AcquireAndRecycle) {
+    object_pool<Message> pool;
+    Message* first;
+    {
+        auto m = pool.acquire(7);
+        EXPECT_EQ(m->id, 7);
+        first = m.get();
+    }
+    auto m = pool.acquire(8);
+    EXPECT_EQ(m.get(), first);      // slot reused, not freed
+    EXPECT_EQ(m->id, 8);
+
+    auto s = pool.get_stats();
+    EXPECT_EQ(s.acquires, 2);
+    EXPECT_EQ(s.hits, 1);
+    EXPECT_EQ(s.high_water, 1);
+    EXPECT_DOUBLE_EQ(s.hit_rate(), 0.5);
+}
+
+TEST(ObjectPoolTest, DestroyModeRunsDestructor) {
+    Message::constructed = 0;
+    Message::destroyed = 0;
+    {
+        object_pool<Message> pool;
+        pool.acquire(1);
+        EXPECT_EQ(Message::destroyed, 1);
+        pool.acquire(2);
+        EXPECT_EQ(Message::constructed, 2);
+    }
+    EXPECT_EQ(Message::destroyed, 2);
+}
+
+TEST(ObjectPoolTest, ResetModeKeepsObjectsConstructed) {
+    Message::constructed = 0;
+    Message::destroyed = 0;
+    {
+        object_pool<Message> pool([](Message& m) { m.id = -1; });
+        pool.acquire(5);
+        auto reused = pool.acquire();
+        EXPECT_EQ(reused->id, -1);              // reset, not reconstructed
+        EXPECT_EQ(Message::constructed, 1);
+        EXPECT_EQ(Message::destroyed, 0);
+
+        reused.reset();
+        auto rebuilt = pool.acquire(9);          // args given: reconstruct
+        EXPECT_EQ(rebuilt->id, 9);
+        EXPECT_EQ(Message::constructed, 2);
+    }
+    EXPECT_EQ(Message::destroyed, 2);
+}
+
+TEST(ObjectPoolTest, HighWaterMark) {
+    object_pool<Message> pool;
+    std::vector<object_pool<Message>::handle> live;
+    for (int i=0; i<10; i++) live.push_back(pool.acquire(i));
+    live.clear();
+    for (int i=0; i<5; i++) live.push_back(pool.acquire(i));
+    EXPECT_EQ(pool.get_stats().high_water, 10);     // peak objects out, not slots
+
+    object_pool<Message> one_at_a_time;
+    for (int i=0; i<10; i++) one_at_a_time.acquire(i);
+    EXPECT_EQ(one_at_a_time.get_stats().high_water, 1);
+}
+
+TEST(ObjectPoolTest, CrossThreadRelease) {
+    object_pool<Message> pool;
+    std::vector<object_pool<Message>::handle> handles;
+    for (int i=0; i<500; i++) handles.push_back(pool.acquire(i));
+
+    std::thread releaser([&] { handles.clear(); });   // spills to the global list
+    releaser.join();
+
+    for (int i=0; i<500; i++) pool.acquire(i);
+    auto s = pool.get_stats();
+    EXPECT_EQ(s.high_water, 500);
+    EXPECT_GT(s.hits, 0);
+}
+
+TEST(ObjectPoolTest, PoolOutlivedByThreadThatUsedIt) {
+    // the thread's cached record must stay valid until the thread exits
+    std::atomic<int> phase{0};
+    auto pool = std::make_unique<object_pool<Message>>();
+    std::thread user([&] {
+        pool->acquire(1);
+        phase = 1;
+        while (phase != 2) std::this_thread::yield();
+    });
+    while (phase != 1) std::this_thread::yield();
+    pool.reset();
+    phase = 2;
+    user.join();
+}
+
+TEST(ObjectPoolTest, ConcurrentChurn) {
+    object_pool<Message> pool;
+    std::vector<std::thread> threads;
+    for (int t=0; t<4; t++) {
+        threads.emplace_back([&pool, t] {
+            std::vector<object_pool<Message>::handle> window;
+            for (int i=0; i<5000; i++) {
+                window.push_back(pool.acquire(t * 10000 + i));
+                if (window.size() > 16) window.erase(window.begin());
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    EXPECT_EQ(pool.get_stats().acquires, 20000);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
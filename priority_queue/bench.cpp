@@ -0,0 +1,97 @@
+// Heap workloads: priority_queue with arity 2/4/8 vs std::priority_queue
+// - push n random keys, then pop them all
+// - heapify n keys (priority_queue(vector&&) vs std::make_heap)
+// - hold n keys while doing pop + push (a scheduler's steady state)
+// g++ -std=c++20 -O2 bench.cpp -o bench && ./bench
+#include "priority_queue.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <queue>
+#include <random>
+#include <vector>
+
+template<typename F>
+double ns_per_op(size_t ops, F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / double(ops);
+}
+
+struct result { double push_pop, heapify, steady; };
+
+template<size_t Arity>
+result run_dary(const std::vector<uint64_t>& keys) {
+    size_t n = keys.size();
+    uint64_t sum = 0;
+    result r;
+    {
+        priority_queue<uint64_t, std::less<uint64_t>, Arity> q;
+        r.push_pop = ns_per_op(n, [&] {
+            for (uint64_t k : keys) q.push(k);
+            while (!q.empty()) sum += q.pop();
+        });
+    }
+    {
+        vector<uint64_t> v(n);
+        for (uint64_t k : keys) v.push_back(k);
+        r.heapify = ns_per_op(n, [&] {
+            priority_queue<uint64_t, std::less<uint64_t>, Arity> q(std::move(v));
+            sum += q.top();
+        });
+    }
+    {
+        priority_queue<uint64_t, std::less<uint64_t>, Arity> q;
+        for (uint64_t k : keys) q.push(k);
+        r.steady = ns_per_op(n, [&] {
+            for (uint64_t k : keys) sum += q.replace_top(k >> 1);
+        });
+    }
+    if (sum == 42) std::puts("");
+    return r;
+}
+
+result run_std(const std::vector<uint64_t>& keys) {
+    size_t n = keys.size();
+    uint64_t sum = 0;
+    result r;
+    {
+        std::priority_queue<uint64_t> q;
+        r.push_pop = ns_per_op(n, [&] {
+            for (uint64_t k : keys) q.push(k);
+            while (!q.empty()) { sum += q.top(); q.pop(); }
+        });
+    }
+    {
+        std::vector<uint64_t> v(keys);
+        r.heapify = ns_per_op(n, [&] {
+            std::make_heap(v.begin(), v.end());
+            sum += v[0];
+        });
+    }
+    {
+        std::priority_queue<uint64_t> q(keys.begin(), keys.end());
+        r.steady = ns_per_op(n, [&] {
+            for (uint64_t k : keys) { sum += q.top(); q.pop(); q.push(k >> 1); }
+        });
+    }
+    if (sum == 42) std::puts("");
+    return r;
+}
+
+int main() {
+    std::mt19937_64 rng(1);
+    std::printf("%9s %-20s %10s %10s %10s   (ns per element)\n", "n", "queue", "push+pop", "heapify", "pop+push");
+    for (size_t n : {1'000, 100'000, 10'000'000}) {
+        std::vector<uint64_t> keys(n);
+        for (auto& k : keys) k = rng();
+        auto print = [&](const char* name, result r) {
+            std::printf("%9zu %-20s %10.1f %10.1f %10.1f\n", n, name, r.push_pop, r.heapify, r.steady);
+        };
+        print("std::priority_queue", run_std(keys));
+        print("arity 2", run_dary<2>(keys));
+        print("arity 4", run_dary<4>(keys));
+        print("arity 8", run_dary<8>(keys));
+    }
+}
@@ -0,0 +1,322 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include "../vector/vector.hpp"
+
+// Heap algorithms on an array with Arity children per node (children of i are
+// Arity*i+1 .. Arity*i+Arity). Like std::priority_queue, the top is the
+// element nothing compares greater than (a max-heap with std::less).
+// - a wider node makes the tree shallower: fewer levels to sift through, and
+//   a 4-ary node's children (4 x 8-byte keys) share one cache line
+// - sifts move a hole instead of swapping: one move per level, not three
+// - moved(element, position) is called whenever an element lands in a slot,
+//   so indexed_priority_queue can track positions; the plain queue passes a
+//   no-op that compiles away
+template<size_t Arity>
+struct dary_heap {
+    static_assert(Arity >= 2, "dary_heap: arity must be at least 2");
+
+    struct no_hook {
+        template<typename T>
+        void operator()(const T&, size_t) const {}
+    };
+
+    static size_t parent(size_t i) { return (i - 1) / Arity; }
+    static size_t first_child(size_t i) { return Arity * i + 1; }
+
+    // move a[i] toward the root until its parent is not less than it
+    template<typename T, typename Compare, typename Moved = no_hook>
+    static void sift_up(T* a, size_t i, Compare& comp, Moved moved = {}) {
+        T x = std::move(a[i]);
+        while (i > 0) {
+            size_t p = parent(i);
+            if (!comp(a[p], x)) break;
+            a[i] = std::move(a[p]);
+            moved(a[i], i);
+            i = p;
+        }
+        a[i] = std::move(x);
+        moved(a[i], i);
+    }
+
+    // move a[i] toward the leaves until no child is greater than it
+    template<typename T, typename Compare, typename Moved = no_hook>
+    static void sift_down(T* a, size_t n, size_t i, Compare& comp, Moved moved = {}) {
+        T x = std::move(a[i]);
+        for (;;) {
+            size_t first = first_child(i);
+            if (first >= n) break;
+            size_t last = first + Arity < n ? first + Arity : n;
+            size_t best = first;
+            for (size_t c = first + 1; c < last; c++) {
+                best = comp(a[best], a[c]) ? c : best;     // cmov, no branch
+            }
+            if (!comp(x, a[best])) break;
+            // the next level's children, needed on the following iteration
+            if (first_child(best) < n) __builtin_prefetch(a + first_child(best));
+            a[i] = std::move(a[best]);
+            moved(a[i], i);
+            i = best;
+        }
+        a[i] = std::move(x);
+        moved(a[i], i);
+    }
+
+    // Bulk build in O(n): sift down every internal node, last one first
+    template<typename T, typename Compare, typename Moved = no_hook>
+    static void make_heap(T* a, size_t n, Compare& comp, Moved moved = {}) {
+        for (size_t i=0; i<n; i++) moved(a[i], i);
+        if (n < 2) return;
+        for (size_t i = parent(n - 1) + 1; i-- > 0; ) sift_down(a, n, i, comp, moved);
+    }
+};
+
+// Priority queue adaptor over vector<T>, 4-ary by default
+// - push/pop move elements; pop() returns the top by value (moved out)
+// - constructing from a vector heapifies it in place in O(n)
+template<typename T, typename Compare = std::less<T>, size_t Arity = 4>
+class priority_queue {
+private:
+    using heap = dary_heap<Arity>;
+
+    vector<T> items;
+    Compare comp;
+
+    T* data() { return items.getSize() ? &items[0] : nullptr; }
+
+public:
+    explicit priority_queue(Compare c = Compare()) : comp(c) {}
+
+    // Take ownership of v and heapify it
+    explicit priority_queue(vector<T>&& v, Compare c = Compare()) : items(std::move(v)), comp(c) {
+        heap::make_heap(data(), items.getSize(), comp);
+    }
+
+    // Capacity
+    size_t size() const { return items.getSize(); }
+    bool empty() const { return items.getSize() == 0; }
+
+    // Access
+    const T& top() const {
+        if (empty()) throw std::out_of_range("Empty priority_queue");
+        return items[0];
+    }
+
+    // Modifiers
+    void push(const T& value) {
+        items.push_back(value);
+        heap::sift_up(data(), items.getSize() - 1, comp);
+    }
+    void push(T&& value) {
+        items.push_back(std::move(value));
+        heap::sift_up(data(), items.getSize() - 1, comp);
+    }
+
+    // Remove and return the top element
+    T pop() {
+        if (empty()) throw std::out_of_range("Empty priority_queue");
+        T* a = data();
+        size_t last = items.getSize() - 1;
+        T result = std::move(a[0]);
+        if (last) {
+            a[0] = std::move(a[last]);
+            items.pop();
+            heap::sift_down(data(), last, 0, comp);
+        } else {
+            items.pop();
+        }
+        return result;
+    }
+
+    // Pop, then push, in one sift: replaces the top and returns the old one
+    T replace_top(T value) {
+        if (empty()) throw std::out_of_range("Empty priority_queue");
+        T result = std::move(items[0]);
+        items[0] = std::move(value);
+        heap::sift_down(data(), items.getSize(), 0, comp);
+        return result;
+    }
+
+    // Give up the storage (heap order, not sorted)
+    vector<T> release() {
+        vector<T> out(std::move(items));
+        items = vector<T>();
+        return out;
+    }
+};
+
+// Priority queue whose entries are addressed by handles returned from push()
+// - a handle stays valid until its entry is popped or erased; freed handles
+//   are reused
+// - decrease_key(h, v) raises h's priority (v must not compare less than the
+//   old value: with std::greater, a min-queue, v is a smaller key), erase(h)
+//   and update(h, v) are O(log n) sifts from h's current position
+// - entries live in the heap array next to their handle; pos[handle] is kept
+//   current through dary_heap's moved() hook
+template<typename T, typename Compare = std::less<T>, size_t Arity = 4>
+class indexed_priority_queue {
+public:
+    using handle = size_t;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    using heap = dary_heap<Arity>;
+
+    struct entry {
+        T value;
+        handle id;
+    };
+
+    struct entry_compare {
+        Compare comp;
+        bool operator()(const entry& a, const entry& b) const { return comp(a.value, b.value); }
+    };
+
+    struct track {
+        vector<size_t>* pos;
+        void operator()(const entry& e, size_t i) const { (*pos)[e.id] = i; }
+    };
+
+    vector<entry> entries;
+    vector<size_t> pos;             // handle -> heap position, npos if free
+    vector<handle> free_ids;
+    entry_compare comp;
+
+    entry* data() { return entries.getSize() ? &entries[0] : nullptr; }
+
+    size_t position(handle h) const {
+        if (h >= pos.getSize() || pos[h] == npos) throw std::out_of_range("indexed_priority_queue: invalid handle");
+        return pos[h];
+    }
+
+    // remove the entry at heap position i and return its value
+    T remove_at(size_t i) {
+        entry* a = data();
+        size_t last = entries.getSize() - 1;
+        handle id = a[i].id;
+        T result = std::move(a[i].value);
+        if (i != last) {
+            a[i] = std::move(a[last]);
+            entries.pop();
+            // the moved-in entry may belong above or below i
+            a = data();
+            if (i > 0 && comp(a[heap::parent(i)], a[i])) heap::sift_up(a, i, comp, track{&pos});
+            else heap::sift_down(a, last, i, comp, track{&pos});
+        } else {
+            entries.pop();
+        }
+        pos[id] = npos;
+        free_ids.push_back(id);
+        return result;
+    }
+
+public:
+    explicit indexed_priority_queue(Compare c = Compare()) : comp{c} {}
+
+    // Capacity
+    size_t size() const { return entries.getSize(); }
+    bool empty() const { return entries.getSize() == 0; }
+    bool contains(handle h) const { return h < pos.getSize() && pos[h] != npos; }
+
+    // Access
+    const T& top() const {
+        if (empty()) throw std::out_of_range("Empty indexed_priority_queue");
+        return entries[0].value;
+    }
+    handle top_handle() const {
+        if (empty()) throw std::out_of_range("Empty indexed_priority_queue");
+        return entries[0].id;
+    }
+    const T& value(handle h) const { return entries[position(h)].value; }
+
+    // Modifiers
+    handle push(T value) {
+        handle id;
+        if (free_ids.getSize()) {
+            id = free_ids[free_ids.getSize() - 1];
+            free_ids.pop();
+        } else {
+            id = pos.getSize();
+            pos.push_back(npos);
+        }
+        entries.push_back(entry{std::move(value), id});
+        heap::sift_up(data(), entries.getSize() - 1, comp, track{&pos});
+        return id;
+    }
+
+    T pop() {
+        if (empty()) throw std::out_of_range("Empty indexed_priority_queue");
+        return remove_at(0);
+    }
+
+    T erase(handle h) { return remove_at(position(h)); }
+
+    // Raise h's priority to value (only ever moves it toward the top)
+    void decrease_key(handle h, T value) {
+        size_t i = position(h);
+        if (comp.comp(value, entries[i].value)) {
+            throw std::invalid_argument("indexed_priority_queue::decrease_key would lower priority");
+        }
+        entries[i].value = std::move(value);
+        heap::sift_up(data(), i, comp, track{&pos});
+    }
+
+    // Set h's value, moving it whichever way the new value requires
+    void update(handle h, T value) {
+        size_t i = position(h);
+        bool lower = comp.comp(value, entries[i].value);
+        entries[i].value = std::move(value);
+        if (lower) heap::sift_down(data(), entries.getSize(), i, comp, track{&pos});
+        else heap::sift_up(data(), i, comp, track{&pos});
+    }
+};
+
+// Keeps the k best values seen in a stream (best = greatest under Compare, so
+// std::less keeps the k largest) in O(k) memory and O(log k) per value
+// - internally a heap of the worst kept value on top: a new value either
+//   loses to it (one comparison) or replaces it in one sift
+// - take() returns the kept values best first
+template<typename T, typename Compare = std::less<T>, size_t Arity = 4>
+class top_k {
+private:
+    struct worst_first {
+        Compare comp;
+        bool operator()(const T& a, const T& b) const { return comp(b, a); }
+    };
+
+    priority_queue<T, worst_first, Arity> kept;
+    size_t k;
+    Compare comp;
+
+public:
+    explicit top_k(size_t limit, Compare c = Compare()) : kept(worst_first{c}), k(limit), comp(c) {}
+
+    size_t size() const { return kept.size(); }
+    size_t limit() const { return k; }
+
+    // Worst value still kept - anything not better is rejected
+    const T& threshold() const { return kept.top(); }
+
+    // true if value was kept
+    bool offer(T value) {
+        if (k == 0) return false;
+        if (kept.size() < k) {
+            kept.push(std::move(value));
+            return true;
+        }
+        if (!comp(kept.top(), value)) return false;
+        kept.replace_top(std::move(value));
+        return true;
+    }
+
+    // Kept values, best first; leaves the helper empty
+    vector<T> take() {
+        size_t n = kept.size();
+        vector<T> out(n);
+        while (!kept.empty()) out.push_back(kept.pop());       // worst first
+        for (size_t i=0; i<n/2; i++) std::swap(out[i], out[n - 1 - i]);
+        return out;
+    }
+};
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include "priority_queue.hpp"
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+template<size_t Arity>
+static void check_against_std(size_t n) {
+    std::mt19937 rng(unsigned(n + Arity));
+    priority_queue<int, std::less<int>, Arity> q;
+    std::priority_queue<int> expected;
+    for (size_t i=0; i<n; i++) {
+        int v = int(rng() % 1000);
+        q.push(v);
+        expected.push(v);
+        if (rng() % 3 == 0) {
+            ASSERT_EQ(q.pop(), expected.top());
+            expected.pop();
+        }
+        ASSERT_EQ(q.size(), expected.size());
+    }
+    while (!expected.empty()) {
+        ASSERT_EQ(q.pop(), expected.top());
+        expected.pop();
+    }
+    EXPECT_THROW(q.pop(), std::out_of_range);
+}
+
+TEST(PriorityQueueTest, MatchesStdPriorityQueue) {
+    for (size_t n : {0, 1, 2, 5, 100, 5000}) {
+        check_against_std<2>(n);
+        check_against_std<3>(n);
+        check_against_std<4>(n);
+        check_against_std<8>(n);
+    }
+}
+
+TEST(PriorityQueueTest, HeapifyAndMoveOnlyValues) {
+    vector<std::unique_ptr<int>> v;
+    for (int i : {5, 1, 9, 3, 7, 2, 8}) v.push_back(std::make_unique<int>(i));
+    auto by_value = [](const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) { return *a > *b; };
+    priority_queue<std::unique_ptr<int>, decltype(by_value)> q(std::move(v), by_value);   // min-queue
+
+    EXPECT_EQ(*q.top(), 1);
+    std::vector<int> order;
+    while (!q.empty()) order.push_back(*q.pop());
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 5, 7, 8, 9}));
+}
+
+TEST(PriorityQueueTest, ReplaceTopAndRelease) {
+    priority_queue<std::string> q;
+    q.push("b");
+    q.push("d");
+    q.push("a");
+    EXPECT_EQ(q.replace_top("c"), "d");
+    EXPECT_EQ(q.top(), "c");
+    q.push(q.top());
+    q.push(q.top());                        // 5th element: the storage grows
+    EXPECT_EQ(q.pop(), "c");
+    EXPECT_EQ(q.pop(), "c");
+    vector<std::string> rest = q.release();
+    EXPECT_EQ(rest.getSize(), 3);
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(IndexedPriorityQueueTest, DecreaseKeyEraseAndUpdate) {
+    // min-queue, as in Dijkstra: decrease_key lowers a distance
+    indexed_priority_queue<int, std::greater<int>> q;
+    auto a = q.push(50), b = q.push(40), c = q.push(30), d = q.push(20);
+    EXPECT_EQ(q.top_handle(), d);
+
+    q.decrease_key(a, 10);
+    EXPECT_EQ(q.top_handle(), a);
+    EXPECT_THROW(q.decrease_key(b, 45), std::invalid_argument);
+
+    EXPECT_EQ(q.erase(d), 20);
+    EXPECT_FALSE(q.contains(d));
+    EXPECT_THROW(q.erase(d), std::out_of_range);
+
+    q.update(a, 100);                       // now the lowest priority
+    EXPECT_EQ(q.pop(), 30);
+    EXPECT_EQ(q.value(b), 40);
+    auto e = q.push(1);
+    EXPECT_EQ(e, c);                        // the last freed handle is reused first
+    EXPECT_EQ(q.pop(), 1);
+    EXPECT_EQ(q.pop(), 40);
+    EXPECT_EQ(q.pop(), 100);
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(IndexedPriorityQueueTest, RandomOpsMatchReference) {
+    std::mt19937 rng(3);
+    indexed_priority_queue<int, std::less<int>, 3> q;
+    std::vector<std::pair<size_t, int>> live;           // (handle, value)
+    for (int step=0; step<20000; step++) {
+        int op = int(rng() % 5);
+        if (op <= 1 || live.empty()) {
+            int v = int(rng() % 100000);
+            live.push_back({q.push(v), v});
+        } else if (op == 2) {
+            size_t j = rng() % live.size();
+            int v = live[j].second + int(rng() % 1000);
+            q.decrease_key(live[j].first, v);           // max-queue: raising the value
+            live[j].second = v;
+        } else if (op == 3) {
+            size_t j = rng() % live.size();
+            ASSERT_EQ(q.erase(live[j].first), live[j].second);
+            live.erase(live.begin() + ptrdiff_t(j));
+        } else {
+            auto best = std::max_element(live.begin(), live.end(),
+                [](auto& x, auto& y) { return x.second < y.second; });
+            ASSERT_EQ(q.top(), best->second);
+            q.pop();
+            // any handle holding the max may have been popped
+            for (auto it = live.begin(); it != live.end(); ++it) {
+                if (!q.contains(it->first)) { live.erase(it); break; }
+            }
+        }
+        ASSERT_EQ(q.size(), live.size());
+    }
+}
+
+TEST(TopKTest, KeepsLargestInOrder) {
+    std::mt19937 rng(11);
+    std::vector<int> all;
+    top_k<int> best(10);
+    for (int i=0; i<10000; i++) {
+        int v = int(rng() % 1000000);
+        all.push_back(v);
+        best.offer(v);
+    }
+    std::sort(all.rbegin(), all.rend());
+    EXPECT_EQ(best.threshold(), all[9]);
+    vector<int> got = best.take();
+    ASSERT_EQ(got.getSize(), 10);
+    for (size_t i=0; i<10; i++) EXPECT_EQ(got[i], all[i]);
+
+    top_k<int, std::greater<int>> smallest(3);
+    for (int v : {5, 3, 9, 1, 7}) smallest.offer(v);
+    vector<int> low = smallest.take();
+    EXPECT_EQ(low[0], 1);
+    EXPECT_EQ(low[2], 5);
+    EXPECT_FALSE(top_k<int>(0).offer(1));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
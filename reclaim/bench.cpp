@@ -0,0 +1,80 @@
+// Read-mostly snapshot: per-access shared_ptr refcounting vs epoch pinning vs hazard pointers
+// g++ -std=c++20 -O2 -pthread bench.cpp -o bench && ./bench
+#include "epoch.hpp"
+#include "hazard_pointer.hpp"
+#include "../shared_ptr/atomic_shared_ptr.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+struct Config {
+    long values[8];
+    explicit Config(long v) { for (long& x : values) x = v; }
+};
+
+// readers read the current config in a loop while one writer replaces it
+template<typename Read, typename Replace>
+double reads_mops(unsigned readers, Read read, Replace replace) {
+    std::atomic<bool> done{false};
+    std::atomic<size_t> reads{0};
+    std::vector<std::thread> pool;
+    for (unsigned t=0; t<readers; t++) {
+        pool.emplace_back([&] {
+            size_t local = 0;
+            long sink = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                sink += read();
+                local++;
+            }
+            asm volatile("" : : "r"(sink));
+            reads += local;
+        });
+    }
+    std::thread writer([&] {
+        long version = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            replace(++version);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    done = true;
+    for (auto& th : pool) th.join();
+    writer.join();
+    return reads.load() / 0.5 / 1e6;
+}
+
+int main() {
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned readers = 1; readers <= max_threads; readers *= 2) {
+        atomic_shared_ptr<Config> shared(make_shared<Config>(0));
+        double refcounted = reads_mops(readers,
+            [&] { return shared.load()->values[0]; },
+            [&](long v) { shared.store(make_shared<Config>(v)); });
+
+        epoch_domain epochs;
+        std::atomic<Config*> ebr_slot{new Config(0)};
+        double ebr = reads_mops(readers,
+            [&] {
+                auto g = epochs.pin();
+                return ebr_slot.load(std::memory_order_acquire)->values[0];
+            },
+            [&](long v) { epochs.retire(ebr_slot.exchange(new Config(v))); });
+        delete ebr_slot.load();
+
+        hazard_domain hazards;
+        std::atomic<Config*> hp_slot{new Config(0)};
+        double hp = reads_mops(readers,
+            [&] {
+                auto h = hazards.make_hazard();
+                return h.protect(hp_slot)->values[0];
+            },
+            [&](long v) { hazards.retire(hp_slot.exchange(new Config(v))); });
+        delete hp_slot.load();
+
+        std::printf("readers=%-2u  shared_ptr %7.2f  epoch %7.2f  hazard %7.2f  Mreads/s\n",
+            readers, refcounted, ebr, hp);
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "retired.hpp"
+
+// Epoch-based reclamation
+// - readers pin() the current global epoch for the length of a read section;
+//   pinning touches only the thread's own record, no shared counters
+// - retire() puts an object in the bag of the epoch it was retired in
+// - the global epoch advances once every pinned thread has seen it;
+//   a bag is freed when the epoch is two ahead of it - no reader can still see it
+// - a stalled pinned reader blocks all reclamation (use hazard pointers if that matters)
+class epoch_domain {
+private:
+    static constexpr size_t bag_count = 3;
+    static constexpr size_t collect_threshold = 64;
+
+    struct Record {
+        std::atomic<unsigned> refs{0};
+        Record* next = nullptr;
+        // 0 = not pinned, else (epoch << 1) | 1
+        std::atomic<uint64_t> state{0};
+        unsigned nesting = 0;
+        std::vector<retired_ptr> bags[bag_count];
+        uint64_t bag_epoch[bag_count] = {0, 0, 0};
+        size_t retired_since_collect = 0;
+    };
+
+    std::atomic<uint64_t> global_epoch{1};
+    record_registry<Record> registry;
+    uint64_t id = next_domain_id();
+
+    friend class thread_records<epoch_domain, Record>;
+
+    Record* local() { return thread_records<epoch_domain, Record>::get(this); }
+
+    // advance only if every pinned thread has observed the current epoch
+    bool try_advance() {
+        uint64_t e = global_epoch.load(std::memory_order_seq_cst);
+        for (Record* r = registry.first(); r; r = r->next) {
+            uint64_t s = r->state.load(std::memory_order_seq_cst);
+            if ((s & 1) && (s >> 1) != e) return false;
+        }
+        return global_epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+    }
+
+    // free this thread's bags that are two or more epochs old
+    void collect(Record* r) {
+        uint64_t e = global_epoch.load(std::memory_order_acquire);
+        for (size_t i=0; i<bag_count; i++) {
+            if (!r->bags[i].empty() && r->bag_epoch[i] + 2 <= e) {
+                reclaim_all(r->bags[i]);
+            }
+        }
+        r->retired_since_collect = 0;
+    }
+
+    void unpin(Record* r) {
+        if (--r->nesting == 0) r->state.store(0, std::memory_order_release);
+    }
+
+public:
+    // RAII read section - objects loaded while it lives stay valid
+    class guard {
+    private:
+        epoch_domain* domain;
+        Record* record;
+
+    public:
+        guard(epoch_domain* d, Record* r) : domain(d), record(r) {}
+        guard(guard&& other) noexcept : domain(other.domain), record(other.record) {
+            other.record = nullptr;
+        }
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+        guard& operator=(guard&&) = delete;
+        ~guard() { if (record) domain->unpin(record); }
+    };
+
+    epoch_domain() = default;
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+
+    // no thread may be pinned or retiring any more
+    ~epoch_domain() {
+        thread_records<epoch_domain, Record>::forget(this);
+        for (Record* r = registry.first(); r; r = r->next) {
+            for (auto& bag : r->bags) reclaim_all(bag);
+        }
+    }
+
+    // process-wide domain for code that does not need its own
+    static epoch_domain& global() {
+        static epoch_domain domain;
+        return domain;
+    }
+
+    // Pin - nested pins on one thread share the outermost epoch
+    guard pin() {
+        Record* r = local();
+        if (r->nesting++ == 0) {
+            uint64_t e = global_epoch.load(std::memory_order_relaxed);
+            // seq_cst RMW orders the announcement before any later loads
+            r->state.exchange((e << 1) | 1, std::memory_order_seq_cst);
+        }
+        return guard(this, r);
+    }
+
+    // Retire - free p with Deleter once no pinned reader can still reach it
+    template<typename T, typename Deleter = std::default_delete<T>>
+    void retire(T* p, Deleter d = Deleter()) {
+        Record* r = local();
+        uint64_t e = global_epoch.load(std::memory_order_acquire);
+        size_t i = e % bag_count;
+        // bag last used three epochs ago or more - its contents are safe
+        if (r->bag_epoch[i] != e) {
+            reclaim_all(r->bags[i]);
+            r->bag_epoch[i] = e;
+        }
+        r->bags[i].push_back(make_retired<T, Deleter>(p, std::move(d)));
+
+        if (++r->retired_since_collect >= collect_threshold) {
+            try_advance();
+            collect(r);
+        }
+    }
+
+    // Best effort: advance as far as readers allow and free this thread's bags
+    void flush() {
+        for (size_t i=0; i<bag_count; i++) try_advance();
+        collect(local());
+    }
+
+    uint64_t epoch() const { return global_epoch.load(std::memory_order_relaxed); }
+};
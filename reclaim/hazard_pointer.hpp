@@ -0,0 +1,131 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "retired.hpp"
+
+// Hazard-pointer reclamation
+// - a reader publishes the exact pointer it is about to use in one of its slots
+// - retire() queues the object; a scan frees every queued object no slot points to
+// - bounded garbage: a stalled reader pins at most slots_per_thread objects
+// - costs a store + full fence per protected load, unlike epoch pinning
+class hazard_domain {
+private:
+    static constexpr size_t slots_per_thread = 4;
+    static constexpr size_t scan_threshold = 64;
+
+    struct Record {
+        std::atomic<unsigned> refs{0};
+        Record* next = nullptr;
+        std::atomic<void*> slots[slots_per_thread] = {};
+        unsigned used_mask = 0;
+        std::vector<retired_ptr> retired;
+    };
+
+    record_registry<Record> registry;
+    uint64_t id = next_domain_id();
+
+    friend class thread_records<hazard_domain, Record>;
+
+    Record* local() { return thread_records<hazard_domain, Record>::get(this); }
+
+    // free every retired object of r not named in any slot
+    void scan(Record* r) {
+        std::vector<void*> hazards;
+        for (Record* other = registry.first(); other; other = other->next) {
+            for (auto& slot : other->slots) {
+                void* p = slot.load(std::memory_order_seq_cst);
+                if (p) hazards.push_back(p);
+            }
+        }
+        std::sort(hazards.begin(), hazards.end());
+
+        size_t kept = 0;
+        for (size_t i=0; i<r->retired.size(); i++) {
+            if (std::binary_search(hazards.begin(), hazards.end(), r->retired[i].ptr)) {
+                r->retired[kept++] = r->retired[i];
+            } else {
+                r->retired[i].reclaim();
+            }
+        }
+        r->retired.resize(kept);
+    }
+
+public:
+    // RAII owner of one hazard slot on the calling thread
+    class holder {
+    private:
+        Record* record;
+        unsigned index;
+
+    public:
+        explicit holder(Record* r) : record(r), index(0) {
+            while (index < slots_per_thread && (r->used_mask & (1u << index))) index++;
+            if (index == slots_per_thread) {
+                throw std::length_error("hazard_domain: out of hazard slots");
+            }
+            r->used_mask |= 1u << index;
+        }
+        holder(holder&& other) noexcept : record(other.record), index(other.index) {
+            other.record = nullptr;
+        }
+        holder(const holder&) = delete;
+        holder& operator=(const holder&) = delete;
+        holder& operator=(holder&&) = delete;
+
+        ~holder() {
+            if (!record) return;
+            reset();
+            record->used_mask &= ~(1u << index);
+        }
+
+        // load src and publish it; re-check so the published value was
+        // still reachable after the slot became visible to scanners
+        template<typename T>
+        T* protect(const std::atomic<T*>& src) {
+            T* p = src.load(std::memory_order_relaxed);
+            for (;;) {
+                record->slots[index].store(p, std::memory_order_seq_cst);
+                T* again = src.load(std::memory_order_acquire);
+                if (again == p) return p;
+                p = again;
+            }
+        }
+
+        void reset() {
+            record->slots[index].store(nullptr, std::memory_order_release);
+        }
+    };
+
+    hazard_domain() = default;
+    hazard_domain(const hazard_domain&) = delete;
+    hazard_domain& operator=(const hazard_domain&) = delete;
+
+    // no thread may hold a slot or be retiring any more
+    ~hazard_domain() {
+        thread_records<hazard_domain, Record>::forget(this);
+        for (Record* r = registry.first(); r; r = r->next) reclaim_all(r->retired);
+    }
+
+    static hazard_domain& global() {
+        static hazard_domain domain;
+        return domain;
+    }
+
+    holder make_hazard() { return holder(local()); }
+
+    // Retire - free p with Deleter once no hazard slot names it
+    template<typename T, typename Deleter = std::default_delete<T>>
+    void retire(T* p, Deleter d = Deleter()) {
+        Record* r = local();
+        r->retired.push_back(make_retired<T, Deleter>(p, std::move(d)));
+        if (r->retired.size() >= scan_threshold) scan(r);
+    }
+
+    // Free everything this thread retired that is not currently protected
+    void flush() { scan(local()); }
+};
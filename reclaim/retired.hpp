@@ -0,0 +1,177 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Shared pieces of the reclamation domains (epoch.hpp, hazard_pointer.hpp)
+
+// Type-erased retired object - pointer + function that frees it + the deleter
+// - a trivially copyable deleter of up to two words (stateless ones, a pool
+//   pointer such as object_pool's pool_deleter) is kept inline, no allocation
+// - anything else is moved to the heap and freed after it runs
+// - either way the entry stays trivially copyable, so the lists are plain vectors
+struct retired_ptr {
+    void* ptr;
+    void (*deleter)(void* p, void* state);
+    alignas(void*) unsigned char state[2 * sizeof(void*)];
+
+    void reclaim() { deleter(ptr, state); }
+};
+
+template<typename T, typename Deleter>
+retired_ptr make_retired(T* p, Deleter d) {
+    retired_ptr r;
+    r.ptr = const_cast<void*>(static_cast<const void*>(p));
+    if constexpr (std::is_trivially_copyable_v<Deleter> && sizeof(Deleter) <= sizeof(r.state) &&
+                  alignof(Deleter) <= alignof(void*)) {
+        ::new (static_cast<void*>(r.state)) Deleter(std::move(d));
+        r.deleter = [](void* q, void* state) {
+            (*std::launder(static_cast<Deleter*>(state)))(static_cast<T*>(q));
+        };
+    } else {
+        Deleter* heap = new Deleter(std::move(d));
+        std::memcpy(r.state, &heap, sizeof(heap));
+        r.deleter = [](void* q, void* state) {
+            Deleter* owned;
+            std::memcpy(&owned, state, sizeof(owned));
+            (*owned)(static_cast<T*>(q));
+            delete owned;
+        };
+    }
+    return r;
+}
+
+inline void reclaim_all(std::vector<retired_ptr>& list) {
+    for (retired_ptr& r : list) r.reclaim();
+    list.clear();
+}
+
+// Push-only list of per-thread records
+// - records are never freed while the domain lives, so traversal needs no protection
+// - a thread that exits releases its record; the next thread reuses it,
+//   together with anything still waiting in its retired lists
+// - a record is shared by the registry and the thread using it (refs = 2, 1 when
+//   free); whichever lets go last frees it, so threads may outlive the domain
+// Record needs: std::atomic<unsigned> refs; Record* next;
+template<typename Record>
+class record_registry {
+private:
+    std::atomic<Record*> head{nullptr};
+
+public:
+    record_registry() = default;
+    record_registry(const record_registry&) = delete;
+    record_registry& operator=(const record_registry&) = delete;
+
+    ~record_registry() {
+        Record* r = head.load(std::memory_order_acquire);
+        while (r) {
+            Record* tmp = r;
+            r = r->next;
+            release(tmp);
+        }
+    }
+
+    Record* acquire() {
+        for (Record* r = first(); r; r = r->next) {
+            unsigned expected = 1;
+            if (r->refs.load(std::memory_order_relaxed) == 1 &&
+                r->refs.compare_exchange_strong(expected, 2, std::memory_order_acquire)) {
+                return r;
+            }
+        }
+        Record* r = new Record();
+        r->refs.store(2, std::memory_order_relaxed);
+        Record* old = head.load(std::memory_order_relaxed);
+        do {
+            r->next = old;
+        } while (!head.compare_exchange_weak(old, r,
+                    std::memory_order_release, std::memory_order_relaxed));
+        return r;
+    }
+
+    Record* first() const { return head.load(std::memory_order_acquire); }
+
+    // drop one reference - the registry's at destruction, or a thread's
+    static void release(Record* r) noexcept {
+        if (r->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete r;
+    }
+
+    // only the calling thread still holds r: its domain is gone
+    static bool orphaned(const Record* r) noexcept {
+        return r->refs.load(std::memory_order_acquire) == 1;
+    }
+};
+
+// Per-thread cache of the record this thread holds in each domain
+// - keyed by domain id, so a new domain at a recycled address never hits a stale entry
+// - released on thread exit; a domain that dies first leaves its record to the
+//   last thread holding it, and entries of dead domains are pruned on the next miss
+// - the destroying thread drops its own entry via forget()
+inline uint64_t next_domain_id() {
+    static std::atomic<uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+template<typename Domain, typename Record>
+class thread_records {
+private:
+    using registry = record_registry<Record>;
+
+    struct Entry {
+        uint64_t id;
+        Record* record;
+    };
+    std::vector<Entry> entries;
+
+    static thread_records& local() {
+        thread_local thread_records cache;
+        return cache;
+    }
+
+    void prune() {
+        for (size_t i=0; i<entries.size(); ) {
+            if (registry::orphaned(entries[i].record)) {
+                registry::release(entries[i].record);
+                entries[i] = entries.back();
+                entries.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+
+public:
+    ~thread_records() {
+        for (Entry& e : entries) registry::release(e.record);
+    }
+
+    static Record* get(Domain* d) {
+        thread_records& cache = local();
+        for (Entry& e : cache.entries) {
+            if (e.id == d->id) return e.record;
+        }
+        cache.prune();
+        Record* r = d->registry.acquire();
+        cache.entries.push_back(Entry{d->id, r});
+        return r;
+    }
+
+    static void forget(Domain* d) {
+        auto& list = local().entries;
+        for (size_t i=0; i<list.size(); i++) {
+            if (list[i].id == d->id) {
+                registry::release(list[i].record);
+                list[i] = list.back();
+                list.pop_back();
+                return;
+            }
+        }
+    }
+};
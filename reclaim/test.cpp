@@ -0,0 +1,196 @@
+#include "gtest/gtest.h"
+#include "epoch.hpp"
+#include "hazard_pointer.hpp"
+#include "../object_pool/object_pool.hpp"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Tracked {
+    static std::atomic<int> freed;
+    int value;
+    explicit Tracked(int v) : value(v) {}
+    ~Tracked() { value = -1; ++freed; }
+};
+std::atomic<int> Tracked::freed = 0;
+
+// EpochDomain Tests
+TEST(EpochDomainTest, RetireWithoutReadersFrees) {
+    Tracked::freed = 0;
+    epoch_domain domain;
+    domain.retire(new Tracked(1));
+    domain.flush();
+    EXPECT_EQ(Tracked::freed, 1);
+}
+
+TEST(EpochDomainTest, PinnedReaderDelaysFree) {
+    Tracked::freed = 0;
+    epoch_domain domain;
+    std::atomic<bool> pinned{false}, release{false};
+
+    std::thread reader([&] {
+        auto g = domain.pin();
+        pinned = true;
+        while (!release) std::this_thread::yield();
+    });
+    while (!pinned) std::this_thread::yield();
+
+    domain.retire(new Tracked(1));
+    domain.flush();
+    EXPECT_EQ(Tracked::freed, 0);
+
+    release = true;
+    reader.join();
+    domain.flush();
+    EXPECT_EQ(Tracked::freed, 1);
+}
+
+TEST(EpochDomainTest, NestedPins) {
+    Tracked::freed = 0;
+    epoch_domain domain;
+    {
+        auto outer = domain.pin();
+        {
+            auto inner = domain.pin();
+        }
+        domain.retire(new Tracked(1));
+        domain.flush();
+        EXPECT_EQ(Tracked::freed, 0);   // still pinned by outer
+    }
+    domain.flush();
+    EXPECT_EQ(Tracked::freed, 1);
+}
+
+TEST(EpochDomainTest, DestructorFreesPending) {
+    Tracked::freed = 0;
+    {
+        epoch_domain domain;
+        auto g = domain.pin();
+        domain.retire(new Tracked(1));
+    }
+    EXPECT_EQ(Tracked::freed, 1);
+}
+
+TEST(EpochDomainTest, RetireKeepsStatefulDeleters) {
+    // a pool pointer fits inline: the slot goes back to the pool, not to delete
+    object_pool<Tracked> pool;
+    epoch_domain domain;
+    auto h = pool.acquire(1);
+    Tracked* first = h.get();
+    auto to_pool = h.get_deleter();
+    domain.retire(h.release(), to_pool);
+    domain.flush();
+    EXPECT_EQ(pool.acquire(2).get(), first);
+
+    // a deleter too large to store inline is moved to the heap and still runs
+    Tracked::freed = 0;
+    std::string tag = "counted by a deleter with a std::string in it";
+    int seen = 0;
+    domain.retire(new Tracked(3), [tag, &seen](Tracked* p) { seen = int(tag.size()); delete p; });
+    domain.flush();
+    EXPECT_EQ(Tracked::freed, 1);
+    EXPECT_EQ(seen, int(tag.size()));
+}
+
+// HazardDomain Tests
+TEST(HazardDomainTest, ProtectedObjectSurvivesScan) {
+    Tracked::freed = 0;
+    hazard_domain domain;
+    std::atomic<Tracked*> slot{new Tracked(7)};
+
+    auto h = domain.make_hazard();
+    Tracked* p = h.protect(slot);
+    Tracked* old = slot.exchange(nullptr);
+    domain.retire(old);
+    domain.flush();
+    EXPECT_EQ(Tracked::freed, 0);
+    EXPECT_EQ(p->value, 7);
+
+    h.reset();
+    domain.flush();
+    EXPECT_EQ(Tracked::freed, 1);
+}
+
+TEST(HazardDomainTest, SlotsAreLimited) {
+    hazard_domain domain;
+    std::vector<hazard_domain::holder> holders;
+    for (int i=0; i<4; i++) holders.push_back(domain.make_hazard());
+    EXPECT_THROW(domain.make_hazard(), std::length_error);
+    holders.pop_back();
+    EXPECT_NO_THROW(domain.make_hazard());
+}
+
+TEST(ReclaimTest, DomainDiesBeforeThreadThatUsedIt) {
+    // the thread's cached records must survive the domains until it exits
+    Tracked::freed = 0;
+    std::atomic<int> phase{0};
+    auto epoch = std::make_unique<epoch_domain>();
+    auto hazard = std::make_unique<hazard_domain>();
+
+    std::thread user([&] {
+        { auto g = epoch->pin(); }
+        hazard->retire(new Tracked(1));
+        phase = 1;
+        while (phase != 2) std::this_thread::yield();
+        // touching another domain prunes the dead ones' entries
+        epoch_domain next;
+        next.retire(new Tracked(2));
+        next.flush();
+    });
+    while (phase != 1) std::this_thread::yield();
+    epoch.reset();
+    hazard.reset();
+    EXPECT_EQ(Tracked::freed, 1);
+    phase = 2;
+    user.join();
+    EXPECT_EQ(Tracked::freed, 2);
+}
+
+// Concurrent read-mostly structure: readers dereference, one writer replaces + retires
+template<typename Read>
+void replace_under_readers(Read read, std::atomic<Tracked*>& slot, auto retire) {
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int t=0; t<3; t++) {
+        readers.emplace_back([&] {
+            while (!done) read();
+        });
+    }
+    for (int i=1; i<=5000; i++) retire(slot.exchange(new Tracked(i)));
+    done = true;
+    for (auto& th : readers) th.join();
+}
+
+TEST(EpochDomainTest, ConcurrentReplace) {
+    Tracked::freed = 0;
+    {
+        epoch_domain domain;
+        std::atomic<Tracked*> slot{new Tracked(0)};
+        replace_under_readers([&] {
+            auto g = domain.pin();
+            EXPECT_GE(slot.load(std::memory_order_acquire)->value, 0);
+        }, slot, [&](Tracked* p) { domain.retire(p); });
+        delete slot.load();
+    }
+    EXPECT_EQ(Tracked::freed, 5001);
+}
+
+TEST(HazardDomainTest, ConcurrentReplace) {
+    Tracked::freed = 0;
+    {
+        hazard_domain domain;
+        std::atomic<Tracked*> slot{new Tracked(0)};
+        replace_under_readers([&] {
+            auto h = domain.make_hazard();
+            EXPECT_GE(h.protect(slot)->value, 0);
+        }, slot, [&](Tracked* p) { domain.retire(p); });
+        delete slot.load();
+    }
+    EXPECT_EQ(Tracked::freed, 5001);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
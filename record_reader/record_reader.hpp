@@ -0,0 +1,293 @@
+#pragma once
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../alloc_tracker/alloc_tracker.hpp"
+#include "../string/string.hpp"
+#include "../unique_ptr/unique_ptr.hpp"
+
+// Minimal C++20 generator: a coroutine that co_yields T values, consumed
+// with a range-for. Each yielded value is seen by reference (no copy) and is
+// valid until the loop advances; exceptions thrown in the body are rethrown
+// from begin()/operator++.
+template<typename T>
+class generator {
+public:
+    struct promise_type {
+        const T* current = nullptr;
+        std::exception_ptr error;
+
+        generator get_return_object() { return generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    struct sentinel {};
+
+    struct iterator {
+        std::coroutine_handle<promise_type> h;
+
+        const T& operator*() const { return *h.promise().current; }
+        const T* operator->() const { return h.promise().current; }
+        iterator& operator++() {
+            h.resume();
+            rethrow();
+            return *this;
+        }
+        bool operator==(sentinel) const { return h.done(); }
+        bool operator!=(sentinel) const { return !h.done(); }
+
+        void rethrow() const {
+            if (h.done() && h.promise().error) std::rethrow_exception(h.promise().error);
+        }
+    };
+
+    explicit generator(std::coroutine_handle<promise_type> handle) : h(handle) {}
+    generator(const generator&) = delete;
+    generator& operator=(const generator&) = delete;
+    generator(generator&& other) noexcept : h(other.h) { other.h = nullptr; }
+    ~generator() {
+        if (h) h.destroy();
+    }
+
+    iterator begin() {
+        iterator it{h};
+        h.resume();
+        it.rethrow();
+        return it;
+    }
+    sentinel end() const { return {}; }
+
+private:
+    std::coroutine_handle<promise_type> h;
+};
+
+// How a byte stream is cut into records
+enum class record_framing {
+    delimited,          // records end with options.delimiter (the last one may not)
+    length_prefixed     // uint32 byte count (host order), then the payload
+};
+
+struct record_reader_options {
+    record_framing framing = record_framing::delimited;
+    char delimiter = '\n';
+    size_t buffer_size = size_t(1) << 20;   // rounded up to a page multiple
+    size_t max_record = size_t(64) << 20;   // the buffer grows up to this for long records
+    bool use_mmap = false;                  // map regular files instead of read(); others fall back
+};
+
+// Buffered record reader over a file descriptor
+// - next(view) returns records as string_views into an internal buffer (or
+//   the mapping) - no allocation or copy per record; a view is valid until the
+//   next call
+// - read mode keeps memory constant: one page-aligned buffer, refilled with
+//   large page-aligned reads; only a trailing partial record is moved to the
+//   front before each refill
+// - mmap mode hands out views straight into the mapped file; like read mode
+//   it starts at the descriptor's current offset
+// - next(string&) materializes into a reused string; records() is a generator
+// - throws std::system_error on I/O errors and std::runtime_error on a
+//   truncated length-prefixed record or one longer than max_record
+class record_reader {
+private:
+    static constexpr size_t page = 4096;
+
+    struct munmap_deleter {
+        size_t length = 0;
+        void operator()(const char* p) const noexcept {
+            ::munmap(const_cast<char*>(p), length);
+        }
+    };
+
+    int fd;
+    bool owns_fd;
+    record_reader_options opts;
+
+    // read mode: valid bytes are buf[begin, end); scan marks how far the
+    // current record has already been searched for a delimiter
+    char* buf = nullptr;
+    size_t cap = 0;
+    size_t begin = 0;
+    size_t end = 0;
+    size_t scan = 0;
+    bool eof = false;
+
+    // mmap mode
+    unique_ptr<const char, munmap_deleter> mapping;
+    size_t map_length = 0;
+
+    static size_t round_up(size_t n) { return (n + page - 1) / page * page; }
+
+    static char* allocate(size_t n) {
+        return static_cast<char*>(alloc_tracker::allocate(alloc_kind::other, n, page));
+    }
+    static void deallocate(char* p, size_t n) noexcept {
+        alloc_tracker::deallocate(alloc_kind::other, p, n, page);
+    }
+
+    void setup() {
+        if (opts.max_record < opts.buffer_size) opts.max_record = opts.buffer_size;
+        struct stat st;
+        off_t at = ::lseek(fd, 0, SEEK_CUR);
+        if (opts.use_mmap && at >= 0 && ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            // start where read() would: at the descriptor's current offset,
+            // mapped from the page holding it
+            eof = true;
+            if (at >= st.st_size) return;
+            off_t from = at - at % off_t(::sysconf(_SC_PAGESIZE));
+            map_length = size_t(st.st_size - from);
+            void* p = ::mmap(nullptr, map_length, PROT_READ, MAP_PRIVATE, fd, from);
+            if (p == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "record_reader: mmap");
+            ::madvise(p, map_length, MADV_SEQUENTIAL);
+            mapping = unique_ptr<const char, munmap_deleter>(static_cast<const char*>(p), munmap_deleter{map_length});
+            begin = scan = size_t(at - from);
+            end = map_length;
+            return;
+        }
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        cap = round_up(opts.buffer_size ? opts.buffer_size : 1);
+        buf = allocate(cap);
+    }
+
+    const char* window() const { return mapping.get() ? mapping.get() : buf; }
+
+    // Cut one record from window()[begin, end); false if more bytes are needed
+    bool extract(std::string_view& rec) {
+        size_t avail = end - begin;
+        if (avail == 0) return false;
+        const char* base = window();
+        if (opts.framing == record_framing::delimited) {
+            size_t from = scan > begin ? scan : begin;
+            const void* hit = std::memchr(base + from, opts.delimiter, end - from);
+            if (hit) {
+                size_t pos = size_t(static_cast<const char*>(hit) - base);
+                if (pos - begin > opts.max_record) throw std::runtime_error("record_reader: record exceeds max_record");
+                rec = std::string_view(base + begin, pos - begin);
+                begin = scan = pos + 1;
+                return true;
+            }
+            scan = end;
+            if (avail > opts.max_record) throw std::runtime_error("record_reader: record exceeds max_record");
+            if (eof) {                          // last record, no trailing delimiter
+                rec = std::string_view(base + begin, avail);
+                begin = scan = end;
+                return true;
+            }
+            return false;
+        }
+        uint32_t len;
+        if (avail >= sizeof(len)) {
+            std::memcpy(&len, base + begin, sizeof(len));
+            if (len > opts.max_record) throw std::runtime_error("record_reader: record exceeds max_record");
+            if (avail - sizeof(len) >= len) {
+                rec = std::string_view(base + begin + sizeof(len), len);
+                begin += sizeof(len) + len;
+                return true;
+            }
+        }
+        if (eof) throw std::runtime_error("record_reader: truncated record");
+        return false;
+    }
+
+    // Make room and read more; the partial record is moved so that the read
+    // target (and so every read) stays page-aligned
+    void fill() {
+        size_t partial = end - begin;
+        size_t target = round_up(partial);
+        if (target >= cap) {
+            // room for the longest record (plus its length prefix) and one read
+            size_t limit = round_up(opts.max_record + sizeof(uint32_t)) + page;
+            size_t new_cap = cap * 2 < limit ? cap * 2 : limit;
+            if (new_cap <= cap) throw std::runtime_error("record_reader: record exceeds max_record");
+            char* new_buf = allocate(new_cap);
+            std::memcpy(new_buf + target - partial, buf + begin, partial);
+            deallocate(buf, cap);
+            buf = new_buf;
+            cap = new_cap;
+        } else if (begin != target - partial) {
+            std::memmove(buf + target - partial, buf + begin, partial);
+        }
+        scan = scan > begin ? scan - begin + target - partial : target - partial;
+        begin = target - partial;
+        end = target;
+
+        ssize_t n;
+        do {
+            n = ::read(fd, buf + end, cap - end);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0) throw std::system_error(errno, std::generic_category(), "record_reader: read");
+        if (n == 0) eof = true;
+        end += size_t(n);
+    }
+
+public:
+    // Read from an open descriptor; the caller keeps ownership
+    explicit record_reader(int descriptor, record_reader_options options = {})
+        : fd(descriptor), owns_fd(false), opts(options) {
+        setup();
+    }
+
+    // Open path for reading; the descriptor is closed by the destructor
+    explicit record_reader(const char* path, record_reader_options options = {})
+        : fd(::open(path, O_RDONLY | O_CLOEXEC)), owns_fd(true), opts(options) {
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "record_reader: open");
+        try {
+            setup();
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+    }
+
+    record_reader(const record_reader&) = delete;
+    record_reader& operator=(const record_reader&) = delete;
+
+    ~record_reader() {
+        deallocate(buf, cap);
+        if (owns_fd) ::close(fd);
+    }
+
+    // Next record as a view; false at end of input
+    bool next(std::string_view& rec) {
+        while (!extract(rec)) {
+            if (eof) return false;
+            fill();
+        }
+        return true;
+    }
+
+    // Next record copied into out, reusing its capacity
+    bool next(string& out) {
+        std::string_view rec;
+        if (!next(rec)) return false;
+        out.clear();
+        out.append(rec.data(), rec.size());
+        return true;
+    }
+
+    // for (std::string_view rec : reader.records()) ...
+    generator<std::string_view> records() {
+        std::string_view rec;
+        while (next(rec)) co_yield rec;
+    }
+
+    bool mapped() const { return mapping.get() != nullptr; }
+    size_t buffer_capacity() const { return cap; }
+};
@@ -0,0 +1,177 @@
+#include "gtest/gtest.h"
+#include "record_reader.hpp"
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Temporary file holding the given bytes, removed on destruction
+struct temp_file {
+    char path[32] = "/tmp/record_reader_XXXXXX";
+    explicit temp_file(const std::string& bytes) {
+        int fd = mkstemp(path);
+        EXPECT_GE(fd, 0);
+        EXPECT_EQ(write(fd, bytes.data(), bytes.size()), ssize_t(bytes.size()));
+        close(fd);
+    }
+    ~temp_file() { unlink(path); }
+};
+
+static std::vector<std::string> read_all(const char* path, record_reader_options opts) {
+    record_reader r(path, opts);
+    std::vector<std::string> out;
+    std::string_view rec;
+    while (r.next(rec)) out.emplace_back(rec);
+    return out;
+}
+
+static std::string frame(const std::vector<std::string>& records) {
+    std::string bytes;
+    for (const std::string& rec : records) {
+        uint32_t len = uint32_t(rec.size());
+        bytes.append(reinterpret_cast<const char*>(&len), sizeof(len));
+        bytes += rec;
+    }
+    return bytes;
+}
+
+TEST(RecordReaderTest, SplitsLines) {
+    temp_file f("alpha\nbeta\n\ngamma");           // empty record, no final newline
+    std::vector<std::string> expected{"alpha", "beta", "", "gamma"};
+    EXPECT_EQ(read_all(f.path, {}), expected);
+
+    record_reader_options mm;
+    mm.use_mmap = true;
+    EXPECT_EQ(read_all(f.path, mm), expected);
+
+    record_reader_options tab;
+    tab.delimiter = '\t';
+    EXPECT_EQ(read_all(f.path, tab), std::vector<std::string>{"alpha\nbeta\n\ngamma"});
+}
+
+TEST(RecordReaderTest, RecordsSpanRefillsAndGrowBuffer) {
+    // small buffer: records straddle refills, and one is longer than the buffer
+    std::vector<std::string> expected;
+    std::string bytes;
+    for (int i=0; i<3000; i++) {
+        std::string rec(size_t(i * 37 % 300), char('a' + i % 26));
+        if (i == 1500) rec = std::string(20000, 'z');
+        expected.push_back(rec);
+        bytes += rec + "\n";
+    }
+    temp_file f(bytes);
+
+    record_reader_options opts;
+    opts.buffer_size = 4096;
+    record_reader r(f.path, opts);
+    std::vector<std::string> got;
+    std::string_view rec;
+    while (r.next(rec)) got.emplace_back(rec);
+    EXPECT_EQ(got, expected);
+    EXPECT_GE(r.buffer_capacity(), 20000u);
+    EXPECT_LE(r.buffer_capacity(), 32768u);         // bounded by the longest record
+
+    opts.use_mmap = true;
+    EXPECT_EQ(read_all(f.path, opts), expected);
+}
+
+TEST(RecordReaderTest, MaxRecordEnforced) {
+    temp_file f(std::string(10000, 'x') + "\nshort\n");
+    record_reader_options opts;
+    opts.buffer_size = 4096;
+    opts.max_record = 8192;
+    record_reader r(f.path, opts);
+    std::string_view rec;
+    EXPECT_THROW(r.next(rec), std::runtime_error);
+}
+
+TEST(RecordReaderTest, LengthPrefixed) {
+    std::vector<std::string> expected{"one", "", std::string("bin\0\n\0ary", 9), std::string(9000, 'q')};
+    temp_file f(frame(expected));
+    record_reader_options opts;
+    opts.framing = record_framing::length_prefixed;
+    opts.buffer_size = 4096;
+    EXPECT_EQ(read_all(f.path, opts), expected);
+    opts.use_mmap = true;
+    EXPECT_EQ(read_all(f.path, opts), expected);
+
+    std::string truncated = frame({"complete", "cut short"});
+    truncated.resize(truncated.size() - 3);
+    temp_file t(truncated);
+    record_reader r(t.path, opts);
+    std::string_view rec;
+    ASSERT_TRUE(r.next(rec));
+    EXPECT_EQ(rec, "complete");
+    EXPECT_THROW(r.next(rec), std::runtime_error);
+}
+
+TEST(RecordReaderTest, StartsAtDescriptorOffsetInBothModes) {
+    // skip a header past the first page: both backends see the same records
+    std::string header(5000, 'h');
+    temp_file f(header + "\nalpha\nbeta\n");
+    for (bool use_mmap : {false, true}) {
+        int fd = open(f.path, O_RDONLY);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(lseek(fd, off_t(header.size() + 1), SEEK_SET), off_t(header.size() + 1));
+        record_reader_options opts;
+        opts.use_mmap = use_mmap;
+        {
+            record_reader r(fd, opts);
+            EXPECT_EQ(r.mapped(), use_mmap);
+            std::vector<std::string> got;
+            std::string_view rec;
+            while (r.next(rec)) got.emplace_back(rec);
+            EXPECT_EQ(got, (std::vector<std::string>{"alpha", "beta"}));
+        }
+        close(fd);
+    }
+}
+
+TEST(RecordReaderTest, PipeAndMaterializedStrings) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::thread writer([&] {
+        for (int i=0; i<1000; i++) {
+            std::string line = "line " + std::to_string(i) + "\n";
+            EXPECT_EQ(write(fds[1], line.data(), line.size()), ssize_t(line.size()));
+        }
+        close(fds[1]);
+    });
+
+    record_reader_options opts;
+    opts.use_mmap = true;                           // not a regular file: falls back to read()
+    record_reader r(fds[0], opts);
+    EXPECT_FALSE(r.mapped());
+    string s;
+    int n = 0;
+    while (r.next(s)) {
+        EXPECT_STREQ(s.c_str(), ("line " + std::to_string(n)).c_str());
+        n++;
+    }
+    EXPECT_EQ(n, 1000);
+    writer.join();
+    close(fds[0]);
+}
+
+TEST(RecordReaderTest, GeneratorInterface) {
+    temp_file f("a\nbb\nccc\n");
+    record_reader r(f.path);
+    std::vector<std::string> got;
+    for (std::string_view rec : r.records()) got.emplace_back(rec);
+    EXPECT_EQ(got, (std::vector<std::string>{"a", "bb", "ccc"}));
+
+    temp_file bad(frame({"ok"}) + "xy");
+    record_reader_options opts;
+    opts.framing = record_framing::length_prefixed;
+    record_reader b(bad.path, opts);
+    size_t seen = 0;
+    EXPECT_THROW({ for (std::string_view rec : b.records()) seen += rec.size(); }, std::runtime_error);
+    EXPECT_EQ(seen, 2u);
+
+    EXPECT_THROW(record_reader("/nonexistent/file"), std::system_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include "shared_ptr.hpp"
+
+// Lock-free atomic slot holding a shared_ptr<T>, for read-mostly publication
+//
+// Split reference count: one 64-bit word = control block pointer (low 48 bits)
+// + number of references readers have taken from it (high 16 bits).
+// On store the slot pre-pays `batch` strong references on the control block.
+// load() claims one of them with a single CAS on the word instead of bumping
+// the strong count; a writer never blocks readers and vice versa.
+// When the slot is overwritten, the unclaimed references are given back.
+// Assumes user-space addresses fit in 48 bits (x86-64, AArch64).
+// Only the control block is stored, and adopt() takes its managed pointer as
+// the T*. A shared_ptr pointing elsewhere (a base at a non-zero offset under
+// multiple inheritance, or an alias) is held through a small forwarding block
+// whose managed pointer is exactly its T*; compare_exchange then matches what
+// load() returned rather than the original shared_ptr.
+template<typename T>
+class atomic_shared_ptr {
+private:
+    using block = ControlBlockBase<atomic_count>;
+
+    static_assert(sizeof(void*) == 8, "pointer packing needs 64-bit pointers");
+
+    static constexpr int count_shift = 48;
+    static constexpr uintptr_t one = uintptr_t(1) << count_shift;
+    static constexpr uintptr_t ptr_mask = one - 1;
+    static constexpr size_t batch = size_t(1) << 15;
+
+    // mutable: load() claims references even through a const slot
+    mutable std::atomic<uintptr_t> word;
+
+    static block* block_of(uintptr_t w) { return reinterpret_cast<block*>(w & ptr_mask); }
+    static size_t claimed(uintptr_t w) { return w >> count_shift; }
+
+    // forwarding block's deleter: keeps the original owner alive
+    struct forward_owner {
+        shared_ptr<T> owner;
+        void operator()(T*) noexcept { owner.reset(); }
+    };
+
+    static shared_ptr<T> adopt(block* cb) {
+        return shared_ptr<T>::adopt(static_cast<T*>(cb->managed()), cb);
+    }
+
+    // take over sp's reference and top it up to a full batch
+    static uintptr_t prepay(shared_ptr<T>& sp) {
+        block* cb = sp.control;
+        if (cb && static_cast<const void*>(sp.ptr) != cb->managed()) {
+            T* p = sp.ptr;
+            cb = new PointerControlBlock<T, forward_owner, atomic_count>(p, forward_owner{std::move(sp)});
+        }
+        sp.ptr = nullptr;
+        sp.control = nullptr;
+        if (cb) cb->strong_count.increment(batch - 1);
+        return reinterpret_cast<uintptr_t>(cb);
+    }
+
+    // undo prepay() without dropping the caller's own reference
+    static shared_ptr<T> refund(uintptr_t w) {
+        block* cb = block_of(w);
+        if (cb) cb->strong_count.decrement(batch - 1);
+        return cb ? adopt(cb) : shared_ptr<T>();
+    }
+
+    // word was removed from the slot: return unclaimed references,
+    // keep one for the caller
+    static shared_ptr<T> retire(uintptr_t w) {
+        block* cb = block_of(w);
+        if (!cb) return shared_ptr<T>();
+        size_t unclaimed = batch - claimed(w);
+        if (unclaimed > 1) cb->strong_count.decrement(unclaimed - 1);
+        return adopt(cb);
+    }
+
+public:
+    // Constructors/Destructor
+    atomic_shared_ptr() noexcept : word(0) {}
+
+    explicit atomic_shared_ptr(shared_ptr<T> desired) : word(prepay(desired)) {}
+
+    ~atomic_shared_ptr() {
+        retire(word.load(std::memory_order_acquire));
+    }
+
+    // Delete Copy operations - the slot itself is not a value
+    atomic_shared_ptr(const atomic_shared_ptr&) = delete;
+    atomic_shared_ptr& operator=(const atomic_shared_ptr&) = delete;
+
+    // Load - claim one pre-paid reference with a CAS on the slot word
+    shared_ptr<T> load() const {
+        uintptr_t cur = word.load(std::memory_order_acquire);
+        for (;;) {
+            block* cb = block_of(cur);
+            if (!cb) return shared_ptr<T>();
+
+            // every pre-paid reference claimed, wait for a refill
+            if (claimed(cur) + 1 >= batch) {
+                std::this_thread::yield();
+                cur = word.load(std::memory_order_acquire);
+                continue;
+            }
+            if (!word.compare_exchange_weak(cur, cur + one,
+                    std::memory_order_acquire, std::memory_order_acquire)) {
+                continue;
+            }
+
+            // we own a reference now, so cb stays alive for the refill
+            size_t used = claimed(cur) + 1;
+            if (used >= batch / 2) {
+                cb->strong_count.increment(used);
+                uintptr_t expected = cur + one;
+                if (!word.compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(cb),
+                        std::memory_order_relaxed, std::memory_order_relaxed)) {
+                    // someone else refilled or replaced the slot
+                    cb->strong_count.decrement(used);
+                }
+            }
+            return adopt(cb);
+        }
+    }
+
+    // Modifiers
+    void store(shared_ptr<T> desired) {
+        exchange(std::move(desired));
+    }
+
+    shared_ptr<T> exchange(shared_ptr<T> desired) {
+        uintptr_t old = word.exchange(prepay(desired), std::memory_order_acq_rel);
+        return retire(old);
+    }
+
+    // Compares control blocks; on failure `expected` is set to the current value
+    bool compare_exchange_strong(shared_ptr<T>& expected, shared_ptr<T> desired) {
+        uintptr_t next = prepay(desired);
+        uintptr_t cur = word.load(std::memory_order_acquire);
+        while (block_of(cur) == expected.control) {
+            if (word.compare_exchange_weak(cur, next,
+                    std::memory_order_acq_rel, std::memory_order_acquire)) {
+                retire(cur);
+                return true;
+            }
+        }
+        refund(next);
+        expected = load();
+        return false;
+    }
+
+    bool compare_exchange_weak(shared_ptr<T>& expected, shared_ptr<T> desired) {
+        return compare_exchange_strong(expected, std::move(desired));
+    }
+
+    // Observers
+    bool is_lock_free() const noexcept { return word.is_lock_free(); }
+};
@@ -0,0 +1,141 @@
+// Copy/destroy cost of shared_ptr per count policy, single-threaded and contended,
+// create/destroy churn per allocation path,
+// and read throughput of atomic_shared_ptr vs a mutex while a writer publishes
+// g++ -std=c++20 -O2 -pthread bench.cpp -o bench && ./bench
+#include "shared_ptr.hpp"
+#include "atomic_shared_ptr.hpp"
+#include "pool_allocator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template<typename Count>
+double copy_destroy_ns(size_t iters) {
+    auto sp = make_shared<int, Count>(1);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i=0; i<iters; i++) {
+        shared_ptr<int, Count> copy = sp;
+        // keep the copy from being optimized away
+        asm volatile("" : : "r"(copy.get()) : "memory");
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return secs * 1e9 / iters;
+}
+
+// copies made on a thread that does not own the count
+template<typename Count>
+double foreign_copy_destroy_ns(size_t iters) {
+    auto sp = make_shared<int, Count>(1);
+    double ns = 0;
+    std::thread other([&] {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i=0; i<iters; i++) {
+            shared_ptr<int, Count> copy = sp;
+            asm volatile("" : : "r"(copy.get()) : "memory");
+        }
+        ns = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e9 / iters;
+    });
+    other.join();
+    return ns;
+}
+
+template<typename Make>
+double churn_ns(size_t iters, Make make) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i=0; i<iters; i++) {
+        auto sp = make(int(i));
+        asm volatile("" : : "r"(sp.get()) : "memory");
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return secs * 1e9 / iters;
+}
+
+// every thread copies the same pointer, so the count's cache line ping-pongs
+double contended_ns(unsigned threads, size_t iters) {
+    auto sp = make_shared<int>(1);
+    std::vector<std::thread> pool;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t=0; t<threads; t++) {
+        pool.emplace_back([&sp, iters] {
+            for (size_t i=0; i<iters; i++) {
+                shared_ptr<int> copy = sp;
+                asm volatile("" : : "r"(copy.get()) : "memory");
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return secs * 1e9 / iters;
+}
+
+// readers grab the current snapshot in a loop, one writer republishes it
+template<typename Load, typename Store>
+double snapshot_reads_mops(unsigned readers, Load load, Store store) {
+    std::atomic<bool> done{false};
+    std::atomic<size_t> reads{0};
+    std::vector<std::thread> pool;
+    for (unsigned t=0; t<readers; t++) {
+        pool.emplace_back([&] {
+            size_t local = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                auto snapshot = load();
+                asm volatile("" : : "r"(snapshot.get()) : "memory");
+                local++;
+            }
+            reads += local;
+        });
+    }
+    std::thread writer([&] {
+        int version = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            store(make_shared<int>(version++));
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    done = true;
+    for (auto& th : pool) th.join();
+    writer.join();
+    return reads.load() / 0.5 / 1e6;
+}
+
+int main() {
+    const size_t iters = 20'000'000;
+    std::printf("local_count  copy+destroy: %6.2f ns\n", copy_destroy_ns<local_count>(iters));
+    std::printf("atomic_count copy+destroy: %6.2f ns\n", copy_destroy_ns<atomic_count>(iters));
+    std::printf("biased_count copy+destroy: %6.2f ns (owner thread)\n", copy_destroy_ns<biased_count>(iters));
+    std::printf("atomic_count copy+destroy: %6.2f ns (other thread)\n", foreign_copy_destroy_ns<atomic_count>(iters));
+    std::printf("biased_count copy+destroy: %6.2f ns (other thread)\n", foreign_copy_destroy_ns<biased_count>(iters));
+
+    std::printf("churn make_shared:             %6.2f ns\n",
+        churn_ns(iters, [](int v) { return make_shared<int>(v); }));
+    std::printf("churn shared_ptr(new):         %6.2f ns\n",
+        churn_ns(iters, [](int v) { return shared_ptr<int>(new int(v)); }));
+    std::printf("churn allocate_shared(pool):   %6.2f ns\n",
+        churn_ns(iters, [](int v) { return allocate_shared<int>(pool_allocator<int>(), v); }));
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        std::printf("atomic_count contended threads=%-2u: %6.2f ns/op per thread\n",
+            threads, contended_ns(threads, iters / threads));
+    }
+
+    for (unsigned readers = 1; readers <= max_threads; readers *= 2) {
+        atomic_shared_ptr<int> slot(make_shared<int>(0));
+        double lock_free = snapshot_reads_mops(readers,
+            [&] { return slot.load(); },
+            [&](shared_ptr<int> sp) { slot.store(std::move(sp)); });
+
+        std::mutex mtx;
+        shared_ptr<int> guarded = make_shared<int>(0);
+        double locked = snapshot_reads_mops(readers,
+            [&] { std::lock_guard<std::mutex> lock(mtx); return guarded; },
+            [&](shared_ptr<int> sp) { std::lock_guard<std::mutex> lock(mtx); guarded = std::move(sp); });
+
+        std::printf("snapshot readers=%-2u  atomic_shared_ptr %7.2f Mreads/s  mutex %7.2f Mreads/s\n",
+            readers, lock_free, locked);
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "shared_ptr.hpp"
+
+// Intrusive reference counting - the count lives inside the object
+// - handle is a single pointer, no control block, no extra allocation
+// - T provides intrusive_ptr_add_ref(T*) / intrusive_ptr_release(T*), found by ADL;
+//   deriving from intrusive_ref_counter<T> supplies both
+// - any raw T* can be re-wrapped, since the count travels with the object
+template<typename T>
+class intrusive_ptr {
+private:
+    T* ptr;
+
+public:
+    // Default Constructor
+    intrusive_ptr() noexcept : ptr(nullptr) {}
+
+    // Construct from raw pointer - add_ref = false adopts a reference already taken
+    explicit intrusive_ptr(T* p, bool add_ref = true) : ptr(p) {
+        if (ptr && add_ref) intrusive_ptr_add_ref(ptr);
+    }
+
+    // Copy Constructor
+    intrusive_ptr(const intrusive_ptr& other) : ptr(other.ptr) {
+        if (ptr) intrusive_ptr_add_ref(ptr);
+    }
+
+    // Move Constructor
+    intrusive_ptr(intrusive_ptr&& other) noexcept : ptr(other.ptr) {
+        other.ptr = nullptr;
+    }
+
+    // Destructor
+    ~intrusive_ptr() {
+        if (ptr) intrusive_ptr_release(ptr);
+    }
+
+    // Copy Assignment
+    // add_ref before release so self-assignment is safe
+    intrusive_ptr& operator=(const intrusive_ptr& other) {
+        intrusive_ptr(other).swap(*this);
+        return *this;
+    }
+
+    // Move Assignment
+    intrusive_ptr& operator=(intrusive_ptr&& other) noexcept {
+        intrusive_ptr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    // Modifiers
+    void reset(T* p = nullptr) {
+        intrusive_ptr(p).swap(*this);
+    }
+    void swap(intrusive_ptr& other) noexcept {
+        std::swap(ptr, other.ptr);
+    }
+    // give up ownership without releasing the reference
+    T* detach() noexcept {
+        T* tmp = ptr;
+        ptr = nullptr;
+        return tmp;
+    }
+
+    // Observers
+    T* get() const noexcept { return ptr; }
+    T& operator*() const noexcept { return *ptr; }
+    T* operator->() const noexcept { return ptr; }
+    explicit operator bool() const noexcept {
+        return ptr != nullptr;
+    }
+};
+
+// Base class providing the count - reuses shared_ptr's Count policies
+// (atomic_count by default, local_count for single-threaded graphs)
+template<typename Derived, typename Count = atomic_count>
+class intrusive_ref_counter {
+private:
+    static_assert(!std::is_same_v<Count, biased_count>,
+        "biased_count needs a control block to finish deferred releases");
+
+    mutable Count refs;
+
+protected:
+    intrusive_ref_counter() noexcept : refs(0) {}
+    // copies are new objects - they start unowned
+    intrusive_ref_counter(const intrusive_ref_counter&) noexcept : refs(0) {}
+    intrusive_ref_counter& operator=(const intrusive_ref_counter&) noexcept { return *this; }
+    ~intrusive_ref_counter() = default;
+
+public:
+    size_t use_count() const noexcept { return refs.load(); }
+
+    friend void intrusive_ptr_add_ref(const intrusive_ref_counter* p) noexcept {
+        p->refs.increment();
+    }
+    friend void intrusive_ptr_release(const intrusive_ref_counter* p) noexcept {
+        if (p->refs.decrement()) delete static_cast<const Derived*>(p);
+    }
+};
+
+template<typename T, typename... Args>
+intrusive_ptr<T> make_intrusive(Args&&... args) {
+    return intrusive_ptr<T>(new T(std::forward<Args>(args)...));
+}
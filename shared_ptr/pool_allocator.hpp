@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <new>
+
+// Pooled allocator for high-churn small blocks (e.g. allocate_shared control blocks)
+// - one free list per (thread, block type); freed blocks are cached, not returned to malloc
+// - a block freed on another thread joins that thread's list - same size, so reusable
+// - n > 1 (arrays) and overflow beyond max_cached go straight to operator new/delete
+template<typename T>
+class pool_allocator {
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct FreeList {
+        Slot* head = nullptr;
+        size_t cached = 0;
+
+        ~FreeList() {
+            while (head) {
+                Slot* tmp = head;
+                head = head->next;
+                operator delete(tmp);
+            }
+        }
+    };
+
+    static constexpr size_t max_cached = 4096;
+
+    static FreeList& free_list() {
+        thread_local FreeList list;
+        return list;
+    }
+
+public:
+    using value_type = T;
+
+    pool_allocator() noexcept = default;
+    template<typename U>
+    pool_allocator(const pool_allocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (n != 1) return static_cast<T*>(operator new(n * sizeof(T)));
+        FreeList& list = free_list();
+        if (list.head) {
+            Slot* slot = list.head;
+            list.head = slot->next;
+            list.cached--;
+            return reinterpret_cast<T*>(slot);
+        }
+        return reinterpret_cast<T*>(static_cast<Slot*>(operator new(sizeof(Slot))));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (n != 1) { operator delete(p); return; }
+        FreeList& list = free_list();
+        if (list.cached == max_cached) { operator delete(p); return; }
+        Slot* slot = reinterpret_cast<Slot*>(p);
+        slot->next = list.head;
+        list.head = slot;
+        list.cached++;
+    }
+
+    // stateless - any two pools can free each other's blocks
+    template<typename U>
+    bool operator==(const pool_allocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const pool_allocator<U>&) const noexcept { return false; }
+};
@@ -1,55 +1,431 @@
+#pragma once
 #include <utility>
 #include <cstddef>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "../alloc_tracker/alloc_tracker.hpp"
+
+// Reference count policies
+// atomic_count - safe to copy/destroy owners from any thread (default)
+// local_count  - plain size_t, for object graphs that never leave one thread
+// biased_count - plain count for the creating thread, atomic for everyone else
+struct atomic_count {
+    std::atomic<size_t> n;
+
+    explicit atomic_count(size_t v) noexcept : n(v) {}
+
+    // new owner only needs atomicity, it is not publishing any data
+    void increment(size_t k = 1) noexcept { n.fetch_add(k, std::memory_order_relaxed); }
+
+    // release so our writes to the object happen-before its destruction,
+    // acquire so the destroying thread sees everyone's writes
+    // (acq_rel rather than release + fence: ThreadSanitizer cannot model fences)
+    bool decrement(size_t k = 1) noexcept {
+        return n.fetch_sub(k, std::memory_order_acq_rel) == k;
+    }
+
+    // weak_ptr::lock() - never resurrect a count that already hit zero
+    bool increment_if_nonzero() noexcept {
+        size_t cur = n.load(std::memory_order_relaxed);
+        while (cur != 0) {
+            if (n.compare_exchange_weak(cur, cur + 1,
+                    std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t load() const noexcept { return n.load(std::memory_order_relaxed); }
+};
+
+struct local_count {
+    size_t n;
+
+    explicit local_count(size_t v) noexcept : n(v) {}
+
+    void increment(size_t k = 1) noexcept { n += k; }
+    bool decrement(size_t k = 1) noexcept { return (n -= k) == 0; }
+    bool increment_if_nonzero() noexcept {
+        if (n == 0) return false;
+        ++n;
+        return true;
+    }
+    size_t load() const noexcept { return n; }
+};
+
+// Biased reference counting
+// - the thread that created the count (owner) updates `biased` with no atomics
+// - other threads update `shared`, packed with a state tag in one atomic word
+// - owner's biased count reaching zero merges it into shared; from then on the
+//   count behaves like atomic_count
+// - if another thread drops shared below zero (a reference created by the owner
+//   died elsewhere) the count is queued on the owner, which merges it on its next
+//   decrement, on collect(), or at thread exit - until then destruction is deferred
+// - one small owner record per thread is never freed (counts may outlive the thread);
+//   records stay linked from a global list
+struct biased_count {
+private:
+    static constexpr intptr_t BIASED = 0;
+    static constexpr intptr_t QUEUED = 1;
+    static constexpr intptr_t MERGED = 2;
+
+    struct owner_record {
+        std::atomic<biased_count*> pending{nullptr};
+        owner_record* next_record = nullptr;
+    };
+
+    static owner_record* new_owner_record() {
+        static std::atomic<owner_record*> all{nullptr};
+        owner_record* r = new owner_record();
+        r->next_record = all.load(std::memory_order_relaxed);
+        while (!all.compare_exchange_weak(r->next_record, r, std::memory_order_release)) {}
+        return r;
+    }
+
+    static biased_count* closed() { return reinterpret_cast<biased_count*>(uintptr_t(1)); }
+
+    // merge everything queued on an owner, run on the owner (or after it exited)
+    static void drain(biased_count* list) {
+        while (list) {
+            biased_count* next = list->next_pending;
+            list->merge_and_release();
+            list = next;
+        }
+    }
+
+    struct owner_handle {
+        owner_record* record = new_owner_record();
+        ~owner_handle() {
+            // late pushers see closed() and merge by themselves
+            drain(record->pending.exchange(closed(), std::memory_order_acq_rel));
+        }
+    };
+
+    static owner_record* current() {
+        // plain pointer is constant-initialized, so the fast path skips the TLS init guard
+        thread_local owner_record* record = nullptr;
+        if (!record) {
+            thread_local owner_handle handle;
+            record = handle.record;
+        }
+        return record;
+    }
+
+    owner_record* const owner;              // creating thread, never cleared
+    size_t biased;                          // owner thread only, dead once merged
+    std::atomic<intptr_t> word;             // (shared << 2) | state, shared may go negative
+    biased_count* next_pending = nullptr;
+    void* block = nullptr;
+    void (*on_zero)(void*) = nullptr;
+
+    static intptr_t shared_of(intptr_t w) { return w >> 2; }
+    static intptr_t state_of(intptr_t w) { return w & 3; }
+    static intptr_t pack(intptr_t shared, intptr_t state) { return intptr_t(uintptr_t(shared) << 2) | state; }
+
+    // only the owner thread (or the merge after it exited) sets MERGED,
+    // so the owner reads its own store here
+    bool is_owner() const noexcept {
+        return owner == current() && state_of(word.load(std::memory_order_relaxed)) != MERGED;
+    }
+
+    // fold biased into shared; true if the total is zero
+    // the CAS publishing MERGED is the last access to *this: from then on
+    // another thread may drop the count to zero and free it
+    bool merge() noexcept {
+        intptr_t local = intptr_t(biased);
+        intptr_t w = word.load(std::memory_order_relaxed);
+        intptr_t merged;
+        do {
+            merged = pack(shared_of(w) + local, MERGED);
+        } while (!word.compare_exchange_weak(w, merged,
+                    std::memory_order_acq_rel, std::memory_order_relaxed));
+        return shared_of(merged) == 0;
+    }
+
+    // merge, and release the block if that left it at zero
+    void merge_and_release() noexcept {
+        void* b = block;
+        void (*f)(void*) = on_zero;
+        if (merge()) f(b);
+    }
 
-template<typename T> class shared_ptr;
-template<typename T> class weak_ptr;
+    void enqueue() noexcept {
+        if (!owner) {
+            // no owner to queue on: same as one that already exited
+            merge_and_release();
+            return;
+        }
+        biased_count* head = owner->pending.load(std::memory_order_acquire);
+        do {
+            if (head == closed()) {
+                // owner thread is gone, its biased count is final
+                merge_and_release();
+                return;
+            }
+            next_pending = head;
+        } while (!owner->pending.compare_exchange_weak(head, this,
+                    std::memory_order_acq_rel, std::memory_order_acquire));
+    }
+
+public:
+    explicit biased_count(size_t v) noexcept
+        : owner(current()), biased(v), word(pack(0, BIASED)) {}
+
+    // callback run when a deferred merge finds the count at zero
+    void bind(void* b, void (*f)(void*)) noexcept {
+        block = b;
+        on_zero = f;
+    }
 
-template<typename T>
-struct ControlBlock {
-    size_t strong_count;
-    size_t weak_count;
-    T object;
+    // merge counts queued on the calling thread
+    // once the thread's handle is gone (thread_local/static destruction) the
+    // list stays closed(): pushers merge by themselves, nothing to drain here
+    static void collect() noexcept {
+        owner_record* o = current();
+        biased_count* head = o->pending.load(std::memory_order_relaxed);
+        while (head && head != closed()) {
+            if (o->pending.compare_exchange_weak(head, nullptr,
+                    std::memory_order_acquire, std::memory_order_relaxed)) {
+                drain(head);
+                return;
+            }
+        }
+    }
+
+    void increment(size_t k = 1) noexcept {
+        if (is_owner()) biased += k;
+        else word.fetch_add(intptr_t(k) << 2, std::memory_order_relaxed);
+    }
+
+    bool decrement(size_t k = 1) noexcept {
+        if (is_owner()) {
+            collect();
+        }
+        // re-check: collect() may have merged this count
+        if (is_owner()) {
+            biased -= k;
+            if (biased != 0) return false;
+            // shared went negative - the queued entry will do the merge
+            if (state_of(word.load(std::memory_order_acquire)) == QUEUED) return false;
+            return merge();
+        }
+        intptr_t w = word.load(std::memory_order_relaxed);
+        for (;;) {
+            intptr_t state = state_of(w);
+            intptr_t shared = shared_of(w) - intptr_t(k);
+            intptr_t next_state = (state == BIASED && shared < 0) ? QUEUED : state;
+            if (word.compare_exchange_weak(w, pack(shared, next_state),
+                    std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                if (state == MERGED) return shared == 0;
+                if (next_state != state) enqueue();
+                return false;
+            }
+        }
+    }
+
+    // not yet merged = not yet destroyed, so taking a reference is always safe
+    bool increment_if_nonzero() noexcept {
+        if (is_owner()) {
+            ++biased;
+            return true;
+        }
+        intptr_t w = word.load(std::memory_order_relaxed);
+        for (;;) {
+            if (state_of(w) == MERGED && shared_of(w) == 0) return false;
+            if (word.compare_exchange_weak(w, pack(shared_of(w) + 1, state_of(w)),
+                    std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    // exact on the owner thread or once merged; elsewhere the biased half is
+    // invisible, so an unmerged count reports at least 1 (it cannot have been
+    // destroyed yet) - weak_ptr::expired() then agrees with lock()
+    size_t load() const noexcept {
+        intptr_t w = word.load(std::memory_order_relaxed);
+        intptr_t total = shared_of(w);
+        if (is_owner()) total += intptr_t(biased);
+        else if (state_of(w) != MERGED && total < 1) total = 1;
+        return total > 0 ? size_t(total) : 0;
+    }
+};
+
+// weak counts are rarely hot, keep them plain atomic under biased strong counts
+template<typename Count> struct weak_count_for { using type = Count; };
+template<> struct weak_count_for<biased_count> { using type = atomic_count; };
+
+template<typename T, typename Count = atomic_count> class shared_ptr;
+template<typename T, typename Count = atomic_count> class weak_ptr;
+template<typename T> class atomic_shared_ptr;
+template<typename T, typename Count = atomic_count> class enable_shared_from_this;
+
+// Type-erased control block - shared_ptr<T> only sees the counts,
+// how the object is destroyed and the block freed is up to the derived block
+template<typename Count = atomic_count>
+struct ControlBlockBase {
+    Count strong_count;
+    // weak owners + 1 held jointly by all strong owners,
+    // so whoever drops it to zero is the one that frees the block
+    typename weak_count_for<Count>::type weak_count;
+
+    ControlBlockBase() : strong_count(1), weak_count(1) {
+        // counts that can reach zero outside decrement() (biased_count) call back here
+        if constexpr (requires { strong_count.bind(this, &ControlBlockBase::released_thunk); }) {
+            strong_count.bind(this, &ControlBlockBase::released_thunk);
+        }
+    }
+
+    // last strong owner gone: destroy the object, drop the strong owners' weak reference
+    void strong_released() noexcept {
+        destroy_object();
+        if (weak_count.decrement()) destroy_block();
+    }
+
+    static void released_thunk(void* self) noexcept {
+        static_cast<ControlBlockBase*>(self)->strong_released();
+    }
+
+    virtual void destroy_object() noexcept = 0;   // strong_count reached zero
+    virtual void destroy_block() noexcept = 0;    // weak_count reached zero
+    virtual void* managed() noexcept = 0;         // pointer passed to destroy_object
+
+protected:
+    ~ControlBlockBase() = default;
+};
+
+// make_shared - object embedded in the block, single allocation
+template<typename T, typename Count = atomic_count>
+struct ControlBlock final : ControlBlockBase<Count>, tracked_new<alloc_kind::shared_ptr> {
+    // union so the object can be destroyed before the block is freed
+    union { T object; };
 
     // take in a list of args of any type
     // forward all arguments to T's constructor
     // Args = types, args = values
     template<typename... Args>
     ControlBlock(Args&&... args)
-        : strong_count(1),
-          weak_count(0),
-          object(std::forward<Args>(args)...) {} //in-place construction of T in cb
+        : object(std::forward<Args>(args)...) {} //in-place construction of T in cb
+
+    // object already destroyed when strong_count reached zero
+    ~ControlBlock() {}
+
+    void destroy_object() noexcept override { object.~T(); }
+    void destroy_block() noexcept override { delete this; }
+    void* managed() noexcept override { return &object; }
+};
+
+// shared_ptr(p, deleter) - adopts an existing object, block allocated separately
+template<typename T, typename Deleter, typename Count = atomic_count>
+struct PointerControlBlock final : ControlBlockBase<Count>, tracked_new<alloc_kind::shared_ptr> {
+    T* ptr;
+    Deleter deleter;
+
+    PointerControlBlock(T* p, Deleter d) : ptr(p), deleter(std::move(d)) {}
+
+    void destroy_object() noexcept override { deleter(ptr); }
+    void destroy_block() noexcept override { delete this; }
+    void* managed() noexcept override { return ptr; }
 };
 
-template<typename T>
+// allocate_shared - like ControlBlock, but block memory comes from Alloc
+template<typename T, typename Alloc, typename Count = atomic_count>
+struct AllocControlBlock final : ControlBlockBase<Count> {
+    using block_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<AllocControlBlock>;
+
+    block_alloc alloc;
+    union { T object; };
+
+    template<typename... Args>
+    AllocControlBlock(const Alloc& a, Args&&... args)
+        : alloc(a), object(std::forward<Args>(args)...) {}
+
+    ~AllocControlBlock() {}
+
+    void destroy_object() noexcept override { object.~T(); }
+    void destroy_block() noexcept override {
+        // copy the allocator out before destroying the block that holds it
+        block_alloc a(alloc);
+        this->~AllocControlBlock();
+        std::allocator_traits<block_alloc>::deallocate(a, this, 1);
+    }
+    void* managed() noexcept override { return &object; }
+};
+
+template<typename T, typename Count>
 class shared_ptr {
 private:
     T* ptr;
-    ControlBlock<T>* control;
+    ControlBlockBase<Count>* control;
 
     void release() {
         if (!control) return;
-        if (--control->strong_count== 0) {
-            ptr->~T();
-
-            if (control->weak_count== 0) {
-                delete control;
-            }
+        if (control->strong_count.decrement()) {
+            control->strong_released();
         }
         ptr = nullptr;
         control = nullptr;
     }
-    
+
+    // new owner of an object deriving from enable_shared_from_this:
+    // point its weak_this at us (overload resolution finds the base)
+    template<typename X, typename U>
+    void enable_weak_this(const enable_shared_from_this<X, Count>* base, U* p) {
+        if (base && base->weak_this.expired()) {
+            base->weak_this = shared_ptr<X, Count>(*this, static_cast<X*>(p));
+        }
+    }
+    void enable_weak_this(...) noexcept {}
+
+    // adopts one strong count already held by the caller
+    static shared_ptr adopt(T* p, ControlBlockBase<Count>* cb) noexcept {
+        shared_ptr sp;
+        sp.ptr = p;
+        sp.control = cb;
+        return sp;
+    }
+
 public:
     // Default Constructor
     shared_ptr() noexcept : ptr(nullptr), control(nullptr) {};
 
     // Constructor for make_shared
-    explicit shared_ptr(ControlBlock<T>* cb) : ptr(&cb->object), control(cb) {}
+    // adopts one strong count already held by the caller
+    explicit shared_ptr(ControlBlock<T, Count>* cb) : ptr(&cb->object), control(cb) {
+        enable_weak_this(ptr, ptr);
+    }
+
+    // Take ownership of a raw pointer - two allocations (object + control block)
+    // U may be derived from T; it is deleted as U
+    template<typename U>
+    explicit shared_ptr(U* p) : shared_ptr(p, std::default_delete<U>()) {}
+
+    // Raw pointer + custom deleter (arena free, munmap, pool return...)
+    template<typename U, typename Deleter>
+    shared_ptr(U* p, Deleter d) : ptr(p), control(nullptr) {
+        try {
+            control = new PointerControlBlock<U, Deleter, Count>(p, d);
+        } catch (...) {
+            d(p);   // we were handed ownership, so clean up on failure
+            throw;
+        }
+        enable_weak_this(p, p);
+    }
+
+    // Aliasing Constructor - shares owner's control block but points at p,
+    // e.g. a member or array element of the owned object
+    template<typename U>
+    shared_ptr(const shared_ptr<U, Count>& owner, T* p) noexcept
+        : ptr(p), control(owner.control) {
+        if (control) control->strong_count.increment();
+    }
 
     // Copy Constructor
     shared_ptr(const shared_ptr& other)
         : ptr(other.ptr), control(other.control) {
-        if (control) ++control->strong_count;
+        if (control) control->strong_count.increment();
     }
 
     // Move Constructor
@@ -71,7 +447,7 @@ public:
         control = other.control;
 
         // increase new ownership
-        if (control) ++control->strong_count;
+        if (control) control->strong_count.increment();
 
         return *this;
     }
@@ -112,7 +488,7 @@ public:
     T& operator*() const noexcept { return *ptr; }
     T* operator->() const noexcept { return ptr; }
     size_t use_count() const {
-        return control ? control->strong_count : 0;
+        return control ? control->strong_count.load() : 0;
     }
     bool unique() const {
         return use_count() == 1;
@@ -121,45 +497,51 @@ public:
         return ptr != nullptr;
     }
 
-    // give weak_ptr and make_shared access to private members
-    friend class weak_ptr<T>;
+    // give weak_ptr, atomic_shared_ptr, the factories and other
+    // shared_ptr<U> (aliasing) access to private members
+    template<typename U, typename C> friend class shared_ptr;
+    friend class weak_ptr<T, Count>;
+    friend class atomic_shared_ptr<T>;
 
-    template<typename U, typename... Args>
-    friend shared_ptr<U> make_shared(Args&&...);
+    template<typename U, typename C, typename Alloc, typename... Args>
+    friend shared_ptr<U, C> allocate_shared(const Alloc&, Args&&...);
 };
 
-template <typename T>
+template <typename T, typename Count>
 class weak_ptr {
 private:
-    ControlBlock<T>* control;
+    T* ptr;
+    ControlBlockBase<Count>* control;
 
     void release() {
         if (!control) return;
-        if (--control->weak_count == 0 && control->strong_count == 0) {
-            delete control;
+        if (control->weak_count.decrement()) {
+            control->destroy_block();
         }
+        ptr = nullptr;
         control = nullptr;
     }
 
 public:
     // Default Constructor
-    weak_ptr() noexcept : control(nullptr) {};
+    weak_ptr() noexcept : ptr(nullptr), control(nullptr) {};
 
     // Copy Constructor
     weak_ptr(const weak_ptr& other)
-        : control(other.control) {
-        if (control) ++control->weak_count;
+        : ptr(other.ptr), control(other.control) {
+        if (control) control->weak_count.increment();
     }
 
     // Copy Constructor from shared ptr
-    weak_ptr(const shared_ptr<T>& sp)
-        : control(sp.control) {
-        if (control) ++control->weak_count;
+    weak_ptr(const shared_ptr<T, Count>& sp)
+        : ptr(sp.ptr), control(sp.control) {
+        if (control) control->weak_count.increment();
     }
 
     // Move Constructor
     weak_ptr(weak_ptr&& other) noexcept
-        : control(other.control) {
+        : ptr(other.ptr), control(other.control) {
+        other.ptr = nullptr;
         other.control = nullptr;
     }
 
@@ -175,10 +557,11 @@ public:
         release();
 
         // copy from other
+        ptr = other.ptr;
         control = other.control;
 
         // increase new ownership
-        if (control) ++control->weak_count;
+        if (control) control->weak_count.increment();
 
         return *this;
     }
@@ -190,7 +573,9 @@ public:
         release();
 
         // steal from other
+        ptr = other.ptr;
         control = other.control;
+        other.ptr = nullptr;
         other.control = nullptr;
 
         return *this;
@@ -201,26 +586,78 @@ public:
         release();
     }
     void swap (weak_ptr& other) noexcept {
+        std::swap(ptr, other.ptr);
         std::swap(control, other.control);
     }
 
     // Observers
     size_t use_count() const {
-        return control ? control->strong_count: 0;
+        return control ? control->strong_count.load() : 0;
     }
     bool expired() const {
-        return !control || control->strong_count == 0;
+        return !control || control->strong_count.load() == 0;
+    }
+    // check and increment in one CAS - a separate expired() check could
+    // race with the last owner going away
+    shared_ptr<T, Count> lock() const {
+        if (control && control->strong_count.increment_if_nonzero()) {
+            return shared_ptr<T, Count>::adopt(ptr, control);
+        }
+        return shared_ptr<T, Count>();
+    }
+};
+
+// Base for objects that need to hand out new owners of themselves,
+// e.g. a node registering a callback that keeps it alive.
+// weak_this is filled in by the first shared_ptr that takes ownership.
+template<typename T, typename Count>
+class enable_shared_from_this {
+private:
+    mutable weak_ptr<T, Count> weak_this;
+
+    template<typename U, typename C> friend class shared_ptr;
+
+protected:
+    enable_shared_from_this() noexcept {}
+    // copies are new objects with their own owners
+    enable_shared_from_this(const enable_shared_from_this&) noexcept {}
+    enable_shared_from_this& operator=(const enable_shared_from_this&) noexcept { return *this; }
+    ~enable_shared_from_this() = default;
+
+public:
+    // throws std::bad_weak_ptr if no shared_ptr owns *this
+    shared_ptr<T, Count> shared_from_this() {
+        shared_ptr<T, Count> sp = weak_this.lock();
+        if (!sp) throw std::bad_weak_ptr();
+        return sp;
     }
-    shared_ptr<T> lock() const {
-        if (expired()) return shared_ptr<T>();
-        ++control->strong_count;
-        return shared_ptr<T>(control);
+
+    weak_ptr<T, Count> weak_from_this() const noexcept {
+        return weak_this;
     }
 };
 
 // single heap allocation
-template<typename T, typename... Args>
-shared_ptr<T> make_shared(Args&&... args) {
-    auto* cb = new ControlBlock<T>(std::forward<Args>(args)...);
-    return shared_ptr<T>(cb);
-}
\ No newline at end of file
+// make_shared<T>(...) = atomic counts, make_shared<T, local_count>(...) = single-threaded
+template<typename T, typename Count = atomic_count, typename... Args>
+shared_ptr<T, Count> make_shared(Args&&... args) {
+    auto* cb = new ControlBlock<T, Count>(std::forward<Args>(args)...);
+    return shared_ptr<T, Count>(cb);
+}
+
+// single heap allocation from a user allocator (arena, pool, shared memory...)
+template<typename T, typename Count = atomic_count, typename Alloc, typename... Args>
+shared_ptr<T, Count> allocate_shared(const Alloc& alloc, Args&&... args) {
+    using block = AllocControlBlock<T, Alloc, Count>;
+    typename block::block_alloc a(alloc);
+    block* cb = std::allocator_traits<typename block::block_alloc>::allocate(a, 1);
+    try {
+        new (cb) block(alloc, std::forward<Args>(args)...);
+    } catch (...) {
+        std::allocator_traits<typename block::block_alloc>::deallocate(a, cb, 1);
+        throw;
+    }
+    auto sp = shared_ptr<T, Count>::adopt(&cb->object, cb);
+    sp.enable_weak_this(sp.ptr, sp.ptr);
+    return sp;
+}
@@ -1,5 +1,10 @@
 #include "gtest/gtest.h"
 #include "shared_ptr.hpp"
+#include "atomic_shared_ptr.hpp"
+#include "pool_allocator.hpp"
+#include "intrusive_ptr.hpp"
+#include <thread>
+#include <vector>
 
 struct Foo {
     int x;
@@ -74,6 +79,468 @@ TEST(WeakPtrTest, BasicWeakPtrBehavior) {
     EXPECT_TRUE(wp2.expired());
 }
 
+// Destruction
+struct Counted {
+    static std::atomic<int> destroyed;
+    ~Counted() { ++destroyed; }
+};
+std::atomic<int> Counted::destroyed = 0;
+
+TEST(SharedPtrTest, ObjectDestroyedOnceWithWeakOutstanding) {
+    Counted::destroyed = 0;
+    weak_ptr<Counted> wp;
+    {
+        auto sp = make_shared<Counted>();
+        wp = sp;
+    }
+    EXPECT_EQ(Counted::destroyed, 1);
+    EXPECT_TRUE(wp.expired());
+    EXPECT_FALSE(wp.lock());
+    wp.reset();
+    EXPECT_EQ(Counted::destroyed, 1);
+}
+
+// Raw pointers, deleters, aliasing, allocators
+TEST(SharedPtrTest, FromRawPointer) {
+    Counted::destroyed = 0;
+    {
+        shared_ptr<Counted> sp(new Counted());
+        shared_ptr<Counted> sp2 = sp;
+        EXPECT_EQ(sp.use_count(), 2);
+    }
+    EXPECT_EQ(Counted::destroyed, 1);
+}
+
+TEST(SharedPtrTest, CustomDeleter) {
+    int buffer[4] = {1, 2, 3, 4};
+    int deleted = 0;
+    {
+        // non-owning arena memory - deleter just records the call
+        shared_ptr<int> sp(buffer, [&deleted](int* p) { deleted = *p; });
+        weak_ptr<int> wp = sp;
+        EXPECT_EQ(*wp.lock(), 1);
+    }
+    EXPECT_EQ(deleted, 1);
+}
+
+struct Pair {
+    Foo first;
+    Foo second;
+    Pair(int a, int b) : first(a), second(b) {}
+};
+
+TEST(SharedPtrTest, AliasingConstructor) {
+    auto owner = make_shared<Pair>(1, 2);
+    shared_ptr<Foo> member(owner, &owner->second);
+    EXPECT_EQ(member->x, 2);
+    EXPECT_EQ(owner.use_count(), 2);
+
+    owner.reset();
+    EXPECT_EQ(member.use_count(), 1);
+    EXPECT_EQ(member->x, 2);
+
+    weak_ptr<Foo> wp = member;
+    EXPECT_EQ(wp.lock().get(), member.get());
+}
+
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+    int* allocations;
+
+    explicit CountingAllocator(int* n) : allocations(n) {}
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : allocations(other.allocations) {}
+
+    T* allocate(size_t n) { ++*allocations; return static_cast<T*>(operator new(n * sizeof(T))); }
+    void deallocate(T* p, size_t) { --*allocations; operator delete(p); }
+};
+
+TEST(SharedPtrTest, AllocateShared) {
+    int live = 0;
+    {
+        auto sp = allocate_shared<Foo>(CountingAllocator<Foo>(&live), 42);
+        EXPECT_EQ(sp->x, 42);
+        EXPECT_EQ(live, 1);
+    }
+    EXPECT_EQ(live, 0);
+}
+
+TEST(SharedPtrTest, PoolAllocatorReusesBlocks) {
+    pool_allocator<Foo> pool;
+    const Foo* first;
+    {
+        auto sp = allocate_shared<Foo>(pool, 1);
+        first = sp.get();
+    }
+    auto sp = allocate_shared<Foo>(pool, 2);
+    EXPECT_EQ(sp.get(), first);
+    EXPECT_EQ(sp->x, 2);
+}
+
+// enable_shared_from_this
+struct Node : enable_shared_from_this<Node> {
+    int id;
+    explicit Node(int i) : id(i) {}
+};
+
+TEST(SharedPtrTest, SharedFromThis) {
+    auto sp = make_shared<Node>(1);
+    shared_ptr<Node> self = sp->shared_from_this();
+    EXPECT_EQ(self.get(), sp.get());
+    EXPECT_EQ(sp.use_count(), 2);
+
+    shared_ptr<Node> raw(new Node(2));
+    EXPECT_EQ(raw->shared_from_this().get(), raw.get());
+    EXPECT_EQ(raw.use_count(), 1);
+
+    auto pooled = allocate_shared<Node>(pool_allocator<Node>(), 3);
+    EXPECT_FALSE(pooled->weak_from_this().expired());
+}
+
+TEST(SharedPtrTest, SharedFromThisWithoutOwnerThrows) {
+    Node unowned(1);
+    EXPECT_THROW(unowned.shared_from_this(), std::bad_weak_ptr);
+    EXPECT_TRUE(unowned.weak_from_this().expired());
+}
+
+// IntrusivePtr Tests
+struct AstNode : intrusive_ref_counter<AstNode> {
+    static std::atomic<int> destroyed;
+    int value;
+    explicit AstNode(int v) : value(v) {}
+    ~AstNode() { ++destroyed; }
+};
+std::atomic<int> AstNode::destroyed = 0;
+
+TEST(IntrusivePtrTest, SinglePointerHandle) {
+    static_assert(sizeof(intrusive_ptr<AstNode>) == sizeof(void*));
+    static_assert(!std::is_convertible_v<AstNode*, intrusive_ptr<AstNode>>);
+    static_assert(sizeof(shared_ptr<AstNode>) == 2 * sizeof(void*));
+}
+
+TEST(IntrusivePtrTest, CopyMoveAndRelease) {
+    AstNode::destroyed = 0;
+    {
+        auto a = make_intrusive<AstNode>(5);
+        EXPECT_EQ(a->use_count(), 1);
+
+        intrusive_ptr<AstNode> b = a;
+        EXPECT_EQ(a->use_count(), 2);
+
+        intrusive_ptr<AstNode> c = std::move(b);
+        EXPECT_FALSE(b);
+        EXPECT_EQ(c->value, 5);
+
+        // re-wrap a raw pointer - count travels with the object
+        intrusive_ptr<AstNode> d(a.get());
+        EXPECT_EQ(a->use_count(), 3);
+
+        c = c;
+        EXPECT_EQ(a->use_count(), 3);
+    }
+    EXPECT_EQ(AstNode::destroyed, 1);
+}
+
+TEST(IntrusivePtrTest, DetachAndAdopt) {
+    AstNode::destroyed = 0;
+    auto a = make_intrusive<AstNode>(1);
+    AstNode* raw = a.detach();
+    EXPECT_FALSE(a);
+    EXPECT_EQ(raw->use_count(), 1);
+
+    intrusive_ptr<AstNode> adopted(raw, false);
+    adopted.reset();
+    EXPECT_EQ(AstNode::destroyed, 1);
+}
+
+// Count policies
+TEST(SharedPtrTest, LocalCountPolicy) {
+    auto sp1 = make_shared<Foo, local_count>(7);
+    shared_ptr<Foo, local_count> sp2 = sp1;
+    EXPECT_EQ(sp1.use_count(), 2);
+
+    weak_ptr<Foo, local_count> wp = sp1;
+    sp1.reset();
+    sp2.reset();
+    EXPECT_TRUE(wp.expired());
+    EXPECT_FALSE(wp.lock());
+}
+
+TEST(SharedPtrTest, BiasedCountOwnerThread) {
+    Counted::destroyed = 0;
+    {
+        auto sp = make_shared<Counted, biased_count>();
+        shared_ptr<Counted, biased_count> copy = sp;
+        EXPECT_EQ(sp.use_count(), 2);
+        weak_ptr<Counted, biased_count> wp = sp;
+        EXPECT_TRUE(wp.lock());
+    }
+    EXPECT_EQ(Counted::destroyed, 1);
+}
+
+TEST(SharedPtrTest, BiasedCountSharedWithOtherThread) {
+    Counted::destroyed = 0;
+    auto sp = make_shared<Counted, biased_count>();
+    std::thread other([copy = sp]() mutable {
+        shared_ptr<Counted, biased_count> more = copy;   // shared count
+        copy.reset();
+    });
+    other.join();
+    EXPECT_EQ(Counted::destroyed, 0);
+    sp.reset();                                           // owner merges, count is zero
+    EXPECT_EQ(Counted::destroyed, 1);
+}
+
+TEST(SharedPtrTest, BiasedCountLastOwnerOnOtherThread) {
+    Counted::destroyed = 0;
+    auto sp = make_shared<Counted, biased_count>();
+    weak_ptr<Counted, biased_count> wp = sp;
+
+    // owner's reference dies elsewhere - shared goes negative, merge is queued on us
+    std::thread other([moved = std::move(sp)]() mutable { moved.reset(); });
+    other.join();
+    EXPECT_EQ(Counted::destroyed, 0);
+
+    biased_count::collect();
+    EXPECT_EQ(Counted::destroyed, 1);
+    EXPECT_TRUE(wp.expired());
+}
+
+TEST(SharedPtrTest, BiasedCountOwnerThreadExits) {
+    Counted::destroyed = 0;
+    shared_ptr<Counted, biased_count> handed_over;
+    std::thread owner([&] { handed_over = make_shared<Counted, biased_count>(); });
+    owner.join();
+
+    // owner is gone - the releasing thread merges by itself
+    handed_over.reset();
+    EXPECT_EQ(Counted::destroyed, 1);
+}
+
+TEST(WeakPtrTest, BiasedCountExpiredAgreesWithLockAcrossThreads) {
+    Counted::destroyed = 0;
+    auto sp = make_shared<Counted, biased_count>();
+    weak_ptr<Counted, biased_count> wp = sp;
+
+    // the owner's count is invisible here: still never expired while alive
+    auto observe = [&wp] {
+        bool expired = true, locked = false;
+        size_t count = 0;
+        std::thread other([&] {
+            expired = wp.expired();
+            count = wp.use_count();
+            locked = bool(wp.lock());
+        });
+        other.join();
+        EXPECT_EQ(expired, !locked);
+        EXPECT_EQ(count > 0, locked);
+        return locked;
+    };
+    EXPECT_TRUE(observe());
+
+    // owner's reference dropped elsewhere: queued, not yet destroyed
+    std::thread dropper([moved = std::move(sp)]() mutable { moved.reset(); });
+    dropper.join();
+    EXPECT_TRUE(observe());
+    EXPECT_EQ(Counted::destroyed, 0);
+
+    biased_count::collect();
+    EXPECT_EQ(Counted::destroyed, 1);
+    EXPECT_FALSE(observe());
+}
+
+// constructed before the thread's biased_count handle, so destroyed after it
+struct late_release {
+    shared_ptr<Counted, biased_count> sp;
+    ~late_release() { sp.reset(); }
+};
+
+TEST(SharedPtrTest, BiasedCountReleasedAfterOwnerHandleIsGone) {
+    Counted::destroyed = 0;
+    std::thread owner([] {
+        thread_local late_release holder;
+        holder.sp = make_shared<Counted, biased_count>();
+    });
+    owner.join();
+    EXPECT_EQ(Counted::destroyed, 1);
+}
+
+TEST(SharedPtrTest, BiasedCountOwnerDropsLastWhileOtherThreadHolds) {
+    // the owner's merge races the other thread's release to zero:
+    // nothing may touch the count after the merge publishes it
+    for (int round=0; round<500; round++) {
+        Counted::destroyed = 0;
+        auto sp = make_shared<Counted, biased_count>();
+        std::atomic<int> phase{0};
+        std::thread other([&] {
+            shared_ptr<Counted, biased_count> mine = sp;      // shared count
+            phase.store(1);
+            while (phase.load() != 2) std::this_thread::yield();
+            mine.reset();
+        });
+        while (phase.load() != 1) std::this_thread::yield();
+        phase.store(2);
+        sp.reset();                                           // owner's last reference
+        other.join();
+        EXPECT_EQ(Counted::destroyed, 1);
+    }
+}
+
+TEST(SharedPtrTest, ConcurrentCopyAndDestroy) {
+    auto sp = make_shared<Foo>(1);
+    std::vector<std::thread> threads;
+    for (int t=0; t<4; t++) {
+        threads.emplace_back([&sp] {
+            for (int i=0; i<10000; i++) {
+                shared_ptr<Foo> copy = sp;
+                EXPECT_EQ(copy->x, 1);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    EXPECT_EQ(sp.use_count(), 1);
+}
+
+TEST(WeakPtrTest, ConcurrentLockWhileLastOwnerResets) {
+    for (int round=0; round<100; round++) {
+        Counted::destroyed = 0;
+        auto sp = make_shared<Counted>();
+        weak_ptr<Counted> wp = sp;
+
+        std::thread locker([wp] {
+            for (int i=0; i<1000; i++) {
+                auto locked = wp.lock();
+                if (!locked) break;
+            }
+        });
+        sp.reset();
+        locker.join();
+
+        EXPECT_EQ(Counted::destroyed, 1);
+        EXPECT_TRUE(wp.expired());
+    }
+}
+
+// AtomicSharedPtr Tests
+TEST(AtomicSharedPtrTest, LoadStoreExchange) {
+    atomic_shared_ptr<Foo> slot(make_shared<Foo>(1));
+    EXPECT_TRUE(slot.is_lock_free());
+
+    auto a = slot.load();
+    EXPECT_EQ(a->x, 1);
+    EXPECT_GE(a.use_count(), 2);      // includes references pre-paid by the slot
+
+    slot.store(make_shared<Foo>(2));
+    EXPECT_EQ(slot.load()->x, 2);
+    EXPECT_EQ(a.use_count(), 1);    // slot gave back its unclaimed references
+
+    auto old = slot.exchange(shared_ptr<Foo>());
+    EXPECT_EQ(old->x, 2);
+    EXPECT_EQ(old.use_count(), 1);
+    EXPECT_FALSE(slot.load());
+}
+
+TEST(AtomicSharedPtrTest, CompareExchange) {
+    auto first = make_shared<Foo>(1);
+    atomic_shared_ptr<Foo> slot(first);
+
+    shared_ptr<Foo> expected = make_shared<Foo>(9);
+    EXPECT_FALSE(slot.compare_exchange_strong(expected, make_shared<Foo>(2)));
+    EXPECT_EQ(expected.get(), first.get());
+
+    EXPECT_TRUE(slot.compare_exchange_strong(expected, make_shared<Foo>(3)));
+    EXPECT_EQ(slot.load()->x, 3);
+    expected.reset();
+    EXPECT_EQ(first.use_count(), 1);
+}
+
+TEST(AtomicSharedPtrTest, HoldsRawPointerOwners) {
+    Counted::destroyed = 0;
+    {
+        atomic_shared_ptr<Counted> slot(shared_ptr<Counted>(new Counted()));
+        EXPECT_TRUE(slot.load());
+
+    }
+    EXPECT_EQ(Counted::destroyed, 1);
+
+    // an alias is held through a forwarding block and keeps its owner alive
+    auto owner = make_shared<Pair>(1, 2);
+    atomic_shared_ptr<Foo> member(shared_ptr<Foo>(owner, &owner->second));
+    EXPECT_EQ(member.load().get(), &owner->second);
+    EXPECT_EQ(owner.use_count(), 2);
+    member.store(shared_ptr<Foo>());
+    EXPECT_EQ(owner.use_count(), 1);
+}
+
+struct Left {
+    int l = 1;
+    virtual ~Left() = default;
+};
+struct Right {
+    int r = 2;
+    virtual ~Right() = default;
+};
+struct Both : Left, Right {
+    ~Both() override { ++Counted::destroyed; }
+};
+
+TEST(AtomicSharedPtrTest, BaseAtNonZeroOffset) {
+    // Right sits after Left inside Both: the block's managed pointer is not the Right*
+    Counted::destroyed = 0;
+    {
+        Both* raw = new Both();
+        Right* base = raw;
+        ASSERT_NE(static_cast<void*>(base), static_cast<void*>(raw));
+
+        atomic_shared_ptr<Right> slot{shared_ptr<Right>(raw)};
+        auto loaded = slot.load();
+        EXPECT_EQ(loaded.get(), base);
+        EXPECT_EQ(loaded->r, 2);
+
+        shared_ptr<Right> expected = loaded;
+        EXPECT_TRUE(slot.compare_exchange_strong(expected, shared_ptr<Right>(new Both())));
+        EXPECT_EQ(slot.load()->r, 2);
+        loaded.reset();
+        expected.reset();
+        EXPECT_EQ(Counted::destroyed, 1);
+        EXPECT_EQ(slot.exchange(shared_ptr<Right>())->r, 2);
+    }
+    EXPECT_EQ(Counted::destroyed, 2);
+}
+
+TEST(AtomicSharedPtrTest, ManyLoadsRefillBatch) {
+    auto sp = make_shared<Foo>(5);
+    atomic_shared_ptr<Foo> slot(sp);
+    for (int i=0; i<200000; i++) {
+        EXPECT_EQ(slot.load()->x, 5);
+    }
+    slot.store(shared_ptr<Foo>());
+    EXPECT_EQ(sp.use_count(), 1);
+}
+
+TEST(AtomicSharedPtrTest, ConcurrentReadersWithWriter) {
+    Counted::destroyed = 0;
+    {
+        atomic_shared_ptr<Counted> slot(make_shared<Counted>());
+        std::atomic<bool> done{false};
+        std::vector<std::thread> readers;
+        for (int t=0; t<3; t++) {
+            readers.emplace_back([&] {
+                while (!done.load()) {
+                    auto snapshot = slot.load();
+                    EXPECT_TRUE(snapshot);
+                }
+            });
+        }
+        for (int i=0; i<2000; i++) slot.store(make_shared<Counted>());
+        done = true;
+        for (auto& th : readers) th.join();
+        EXPECT_EQ(Counted::destroyed, 2000);
+    }
+    EXPECT_EQ(Counted::destroyed, 2001);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
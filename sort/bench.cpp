@@ -0,0 +1,68 @@
+// Sorting 10M elements: std::sort vs pdqsort vs radix_sort
+// - uint64_t, int32_t and double keys; {uint64 key, uint64 payload} records
+// - distributions: random, sorted, reversed, few unique (16 values), sawtooth
+// g++ -std=c++20 -O2 bench.cpp -o bench && ./bench [n]
+#include "sort.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct kv {
+    uint64_t key;
+    uint64_t payload;
+};
+
+template<typename T>
+double ms(const std::vector<T>& input, void (*sort_fn)(vector<T>&)) {
+    vector<T> v(input.size());
+    for (const T& x : input) v.push_back(x);
+    auto start = std::chrono::steady_clock::now();
+    sort_fn(v);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename T, typename Less, typename Key>
+void row(const char* type, const char* dist, const std::vector<T>& input) {
+    double s = ms<T>(input, [](vector<T>& v) { if (v.getSize()) std::sort(&v[0], &v[0] + v.getSize(), Less()); });
+    double p = ms<T>(input, [](vector<T>& v) { pdqsort(v, Less()); });
+    double r = ms<T>(input, [](vector<T>& v) { radix_sort(v, Key()); });
+    std::printf("%-8s %-10s %10.1f %10.1f %10.1f\n", type, dist, s, p, r);
+}
+
+template<typename K>
+struct key_less { bool operator()(K a, K b) const { return a < b; } };
+struct kv_less { bool operator()(const kv& a, const kv& b) const { return a.key < b.key; } };
+struct kv_key { uint64_t operator()(const kv& r) const { return r.key; } };
+
+template<typename T, typename Less, typename Key, typename Make>
+void all_distributions(const char* type, size_t n, Make make) {
+    std::mt19937_64 rng(1);
+    std::vector<T> v(n);
+    for (auto& x : v) x = make(rng());
+    row<T, Less, Key>(type, "random", v);
+    std::vector<T> sorted(v);
+    std::sort(sorted.begin(), sorted.end(), Less());
+    row<T, Less, Key>(type, "sorted", sorted);
+    std::reverse(sorted.begin(), sorted.end());
+    row<T, Less, Key>(type, "reversed", sorted);
+    for (auto& x : v) x = make(rng() % 16);
+    row<T, Less, Key>(type, "few uniq", v);
+    for (size_t i=0; i<n; i++) v[i] = make(i % 1000);
+    row<T, Less, Key>(type, "sawtooth", v);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? size_t(std::strtoull(argv[1], nullptr, 10)) : 10'000'000;
+    std::printf("%-8s %-10s %10s %10s %10s   (ms, n = %zu)\n", "type", "input", "std::sort", "pdqsort", "radix", n);
+    all_distributions<uint64_t, key_less<uint64_t>, sort_detail::identity_key>("uint64", n,
+        [](uint64_t r) { return r; });
+    all_distributions<int32_t, key_less<int32_t>, sort_detail::identity_key>("int32", n,
+        [](uint64_t r) { return int32_t(uint32_t(r)); });
+    all_distributions<double, key_less<double>, sort_detail::identity_key>("double", n,
+        [](uint64_t r) { return double(int64_t(r)) / 1e9; });
+    all_distributions<kv, kv_less, kv_key>("record", n,
+        [](uint64_t r) { return kv{r, r * 31}; });
+}
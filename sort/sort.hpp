@@ -0,0 +1,373 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "../alloc_tracker/alloc_tracker.hpp"
+#include "../priority_queue/priority_queue.hpp"
+#include "../vector/vector.hpp"
+
+// Sorting on vector storage
+// - pdqsort: pattern-defeating quicksort for any comparator (not stable).
+//   Introsort-style quicksort, plus:
+//   insertion sort on small ranges, median-of-3 / ninther pivots, a
+//   partial insertion sort when a partition was already in order (sorted and
+//   nearly sorted input is O(n)), equal-to-pivot partitions for inputs with
+//   few unique keys, shuffles after unbalanced partitions, and a heapsort
+//   fallback after log2(n) bad ones, so the worst case is O(n log n)
+// - radix_sort: stable LSD radix sort on 8-bit digits for integral and
+//   floating-point keys, or records by an extracted key. One counting pass
+//   builds every digit's histogram; digits all elements share are skipped;
+//   elements ping-pong between the vector and one scratch buffer
+
+namespace sort_detail {
+
+inline constexpr ptrdiff_t insertion_sort_threshold = 24;
+inline constexpr ptrdiff_t ninther_threshold = 128;
+inline constexpr ptrdiff_t partial_insertion_limit = 8;
+
+template<typename T, typename Compare>
+void insertion_sort(T* first, T* last, Compare& comp) {
+    if (first == last) return;
+    for (T* cur = first + 1; cur != last; ++cur) {
+        if (!comp(*cur, *(cur - 1))) continue;
+        T tmp = std::move(*cur);
+        T* hole = cur;
+        do {
+            *hole = std::move(*(hole - 1));
+            --hole;
+        } while (hole != first && comp(tmp, *(hole - 1)));
+        *hole = std::move(tmp);
+    }
+}
+
+// insertion sort where *(first - 1) is known to be <= every element, so the
+// inner loop needs no bounds check
+template<typename T, typename Compare>
+void unguarded_insertion_sort(T* first, T* last, Compare& comp) {
+    if (first == last) return;
+    for (T* cur = first + 1; cur != last; ++cur) {
+        if (!comp(*cur, *(cur - 1))) continue;
+        T tmp = std::move(*cur);
+        T* hole = cur;
+        do {
+            *hole = std::move(*(hole - 1));
+            --hole;
+        } while (comp(tmp, *(hole - 1)));
+        *hole = std::move(tmp);
+    }
+}
+
+// insertion sort that gives up after moving partial_insertion_limit elements;
+// true if the range ended up sorted
+template<typename T, typename Compare>
+bool partial_insertion_sort(T* first, T* last, Compare& comp) {
+    if (first == last) return true;
+    ptrdiff_t moved = 0;
+    for (T* cur = first + 1; cur != last; ++cur) {
+        if (!comp(*cur, *(cur - 1))) continue;
+        T tmp = std::move(*cur);
+        T* hole = cur;
+        do {
+            *hole = std::move(*(hole - 1));
+            --hole;
+        } while (hole != first && comp(tmp, *(hole - 1)));
+        *hole = std::move(tmp);
+        moved += cur - hole;
+        if (moved > partial_insertion_limit) return false;
+    }
+    return true;
+}
+
+template<typename T, typename Compare>
+void sort2(T* a, T* b, Compare& comp) {
+    if (comp(*b, *a)) std::swap(*a, *b);
+}
+
+// sorts *a, *b, *c
+template<typename T, typename Compare>
+void sort3(T* a, T* b, T* c, Compare& comp) {
+    sort2(a, b, comp);
+    sort2(b, c, comp);
+    sort2(a, b, comp);
+}
+
+// heapsort fallback, on the binary dary_heap
+template<typename T, typename Compare>
+void heap_sort(T* first, T* last, Compare& comp) {
+    size_t n = size_t(last - first);
+    dary_heap<2>::make_heap(first, n, comp);
+    for (size_t end = n; end > 1; end--) {
+        std::swap(first[0], first[end - 1]);
+        dary_heap<2>::sift_down(first, end - 1, 0, comp);
+    }
+}
+
+// Partition [first, last) around the pivot *first: elements < pivot go left.
+// Returns the pivot's final position and whether no element had to move.
+// Pivot selection leaves an element >= pivot at last - 1, which stops the
+// first left-to-right scan; later scans stop at swapped elements.
+template<typename T, typename Compare>
+std::pair<T*, bool> partition_right(T* first, T* last, Compare& comp) {
+    T pivot = std::move(*first);
+    T* lo = first;
+    T* hi = last;
+
+    while (comp(*++lo, pivot)) {}
+    if (lo - 1 == first) {
+        while (lo < hi && !comp(*--hi, pivot)) {}
+    } else {
+        while (!comp(*--hi, pivot)) {}
+    }
+
+    bool already_partitioned = lo >= hi;
+    while (lo < hi) {
+        std::swap(*lo, *hi);
+        while (comp(*++lo, pivot)) {}
+        while (!comp(*--hi, pivot)) {}
+    }
+
+    T* pivot_pos = lo - 1;
+    *first = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return {pivot_pos, already_partitioned};
+}
+
+// Partition with elements equal to the pivot *first going left; used when the
+// pivot equals the element before the range, so everything <= pivot is done.
+// Returns the end of the equal block.
+template<typename T, typename Compare>
+T* partition_left(T* first, T* last, Compare& comp) {
+    T pivot = std::move(*first);
+    T* lo = first;
+    T* hi = last;
+
+    while (comp(pivot, *--hi)) {}
+    if (hi + 1 == last) {
+        while (lo < hi && !comp(pivot, *++lo)) {}
+    } else {
+        while (!comp(pivot, *++lo)) {}
+    }
+
+    while (lo < hi) {
+        std::swap(*lo, *hi);
+        while (comp(pivot, *--hi)) {}
+        while (!comp(pivot, *++lo)) {}
+    }
+
+    *first = std::move(*hi);
+    *hi = std::move(pivot);
+    return hi;
+}
+
+template<typename T, typename Compare>
+void pdqsort_loop(T* first, T* last, Compare& comp, int bad_allowed, bool leftmost) {
+    for (;;) {
+        ptrdiff_t size = last - first;
+        if (size < insertion_sort_threshold) {
+            if (leftmost) insertion_sort(first, last, comp);
+            else unguarded_insertion_sort(first, last, comp);
+            return;
+        }
+
+        // pivot to *first: median of 3, or pseudo-median of 9 for large ranges
+        ptrdiff_t half = size / 2;
+        if (size > ninther_threshold) {
+            sort3(first, first + half, last - 1, comp);
+            sort3(first + 1, first + (half - 1), last - 2, comp);
+            sort3(first + 2, first + (half + 1), last - 3, comp);
+            sort3(first + (half - 1), first + half, first + (half + 1), comp);
+            std::swap(*first, *(first + half));
+        } else {
+            sort3(first + half, first, last - 1, comp);
+        }
+
+        // the element before the range is <= everything in it; if it equals
+        // the pivot, the range has many equal keys - split those off at once
+        if (!leftmost && !comp(*(first - 1), *first)) {
+            first = partition_left(first, last, comp) + 1;
+            continue;
+        }
+
+        auto [pivot_pos, already_partitioned] = partition_right(first, last, comp);
+        ptrdiff_t left_size = pivot_pos - first;
+        ptrdiff_t right_size = last - (pivot_pos + 1);
+
+        if (left_size < size / 8 || right_size < size / 8) {
+            // unbalanced: after too many, switch to heapsort; otherwise swap
+            // a few elements around to break up the pattern that caused it
+            if (--bad_allowed == 0) {
+                heap_sort(first, last, comp);
+                return;
+            }
+            if (left_size >= insertion_sort_threshold) {
+                std::swap(*first, *(first + left_size / 4));
+                std::swap(*(pivot_pos - 1), *(pivot_pos - left_size / 4));
+                if (left_size > ninther_threshold) {
+                    std::swap(*(first + 1), *(first + (left_size / 4 + 1)));
+                    std::swap(*(first + 2), *(first + (left_size / 4 + 2)));
+                    std::swap(*(pivot_pos - 2), *(pivot_pos - (left_size / 4 + 1)));
+                    std::swap(*(pivot_pos - 3), *(pivot_pos - (left_size / 4 + 2)));
+                }
+            }
+            if (right_size >= insertion_sort_threshold) {
+                std::swap(*(pivot_pos + 1), *(pivot_pos + (1 + right_size / 4)));
+                std::swap(*(last - 1), *(last - right_size / 4));
+                if (right_size > ninther_threshold) {
+                    std::swap(*(pivot_pos + 2), *(pivot_pos + (2 + right_size / 4)));
+                    std::swap(*(pivot_pos + 3), *(pivot_pos + (3 + right_size / 4)));
+                    std::swap(*(last - 2), *(last - (1 + right_size / 4)));
+                    std::swap(*(last - 3), *(last - (2 + right_size / 4)));
+                }
+            }
+        } else if (already_partitioned
+                   && partial_insertion_sort(first, pivot_pos, comp)
+                   && partial_insertion_sort(pivot_pos + 1, last, comp)) {
+            // nothing moved and both sides were (nearly) sorted
+            return;
+        }
+
+        // recurse into the left side, loop on the right
+        pdqsort_loop(first, pivot_pos, comp, bad_allowed, leftmost);
+        first = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+// Order-preserving map of a key to an unsigned integer of the same width:
+// signed integers flip the sign bit; floats flip the sign bit of positives
+// and every bit of negatives (so -inf < ... < -0.0 < 0.0 < ... < inf, NaNs
+// with the sign bit clear sort last)
+template<typename K>
+auto radix_key(K k) {
+    if constexpr (std::is_floating_point_v<K>) {
+        static_assert(sizeof(K) == 4 || sizeof(K) == 8, "radix_sort: float or double keys only");
+        using U = std::conditional_t<sizeof(K) == 4, uint32_t, uint64_t>;
+        U u = std::bit_cast<U>(k);
+        U sign = U(1) << (sizeof(U) * 8 - 1);
+        return u & sign ? U(~u) : U(u | sign);
+    } else {
+        static_assert(std::is_integral_v<K>, "radix_sort: key must be integral or floating point");
+        using U = std::make_unsigned_t<K>;
+        if constexpr (std::is_signed_v<K>) return U(U(k) ^ (U(1) << (sizeof(U) * 8 - 1)));
+        else return U(k);
+    }
+}
+
+struct identity_key {
+    template<typename T>
+    const T& operator()(const T& v) const { return v; }
+};
+
+} // namespace sort_detail
+
+// Sort [first, last) with comp
+template<typename T, typename Compare = std::less<T>>
+void pdqsort(T* first, T* last, Compare comp = Compare()) {
+    if (last - first < 2) return;
+    int bad_allowed = std::bit_width(size_t(last - first)) - 1; // floor(log2(n))
+    sort_detail::pdqsort_loop(first, last, comp, bad_allowed, true);
+}
+
+template<typename T, typename Compare = std::less<T>>
+void pdqsort(vector<T>& v, Compare comp = Compare()) {
+    if (v.getSize() < 2) return;
+    pdqsort(&v[0], &v[0] + v.getSize(), comp);
+}
+
+// Stable LSD radix sort with a reusable scratch buffer: sorting many vectors
+// through one radix_sorter allocates only when a larger one comes along
+template<typename T>
+class radix_sorter {
+private:
+    T* scratch = nullptr;
+    size_t scratch_size = 0;
+
+    static T* allocate(size_t n) {
+        return static_cast<T*>(alloc_tracker::allocate(alloc_kind::other, n*sizeof(T), alignof(T)));
+    }
+    static void deallocate(T* p, size_t n) noexcept {
+        alloc_tracker::deallocate(alloc_kind::other, p, n*sizeof(T), alignof(T));
+    }
+
+    // move-construct src[i] into dst[j], leaving src[i] destroyed; for
+    // trivially copyable T this is a plain copy
+    static void relocate(T* dst, T* src) {
+        std::construct_at(dst, std::move(*src));
+        std::destroy_at(src);
+    }
+
+public:
+    radix_sorter() = default;
+    radix_sorter(const radix_sorter&) = delete;
+    radix_sorter& operator=(const radix_sorter&) = delete;
+    ~radix_sorter() { deallocate(scratch, scratch_size); }
+
+    // Sort a[0, n) by key(element), which must return an integral or floating
+    // point value; below 64 elements a stable insertion sort is used instead
+    template<typename KeyFn = sort_detail::identity_key>
+    void sort(T* a, size_t n, KeyFn key = KeyFn()) {
+        using U = decltype(sort_detail::radix_key(key(a[0])));
+        constexpr size_t digits = sizeof(U);
+
+        if (n < 64) {
+            auto by_key = [&](const T& x, const T& y) {
+                return sort_detail::radix_key(key(x)) < sort_detail::radix_key(key(y));
+            };
+            sort_detail::insertion_sort(a, a + n, by_key);
+            return;
+        }
+        if (n > scratch_size) {
+            deallocate(scratch, scratch_size);
+            scratch = nullptr;
+            scratch_size = 0;
+            scratch = allocate(n);
+            scratch_size = n;
+        }
+
+        // every digit's histogram in one pass
+        size_t counts[digits][256] = {};
+        for (size_t i=0; i<n; i++) {
+            U k = sort_detail::radix_key(key(a[i]));
+            for (size_t d=0; d<digits; d++) counts[d][(k >> (8 * d)) & 0xFF]++;
+        }
+
+        T* src = a;
+        T* dst = scratch;
+        U first_key = sort_detail::radix_key(key(a[0]));
+        for (size_t d=0; d<digits; d++) {
+            size_t* c = counts[d];
+            if (c[(first_key >> (8 * d)) & 0xFF] == n) continue;       // all share this digit
+
+            size_t offset[256];
+            size_t sum = 0;
+            for (size_t b=0; b<256; b++) {
+                offset[b] = sum;
+                sum += c[b];
+            }
+            for (size_t i=0; i<n; i++) {
+                size_t b = (sort_detail::radix_key(key(src[i])) >> (8 * d)) & 0xFF;
+                relocate(dst + offset[b]++, src + i);
+            }
+            std::swap(src, dst);
+        }
+        if (src != a) {
+            for (size_t i=0; i<n; i++) relocate(a + i, src + i);
+        }
+    }
+
+    template<typename KeyFn = sort_detail::identity_key>
+    void sort(vector<T>& v, KeyFn key = KeyFn()) {
+        if (v.getSize() < 2) return;
+        sort(&v[0], v.getSize(), key);
+    }
+};
+
+// Sort v by value (integral or floating-point T) or by key(element)
+template<typename T, typename KeyFn = sort_detail::identity_key>
+void radix_sort(vector<T>& v, KeyFn key = KeyFn()) {
+    radix_sorter<T>().sort(v, key);
+}
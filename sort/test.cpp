@@ -0,0 +1,187 @@
+#include "gtest/gtest.h"
+#include "sort.hpp"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+template<typename T>
+static vector<T> to_vector(const std::vector<T>& in) {
+    vector<T> v(in.size());
+    for (const T& x : in) v.push_back(x);
+    return v;
+}
+
+template<typename T>
+static std::vector<T> to_std(vector<T>& v) {
+    return std::vector<T>(v.begin().ptr, v.end().ptr);
+}
+
+// the distributions the bench uses, plus patterns that hurt naive quicksort
+static std::vector<std::vector<int64_t>> int_inputs(size_t n) {
+    std::mt19937_64 rng(n);
+    std::vector<std::vector<int64_t>> out(7, std::vector<int64_t>(n));
+    for (size_t i=0; i<n; i++) {
+        out[0][i] = int64_t(rng());                     // random, full range
+        out[1][i] = int64_t(i);                         // sorted
+        out[2][i] = int64_t(n - i);                     // reversed
+        out[3][i] = int64_t(rng() % 4) - 2;             // few unique, negative too
+        out[4][i] = int64_t(i % 100);                   // sawtooth
+        out[5][i] = i < n / 2 ? int64_t(2 * i) : int64_t(2 * (n - i) + 1);  // organ pipe
+        out[6][i] = 7;                                  // all equal
+    }
+    return out;
+}
+
+TEST(PdqsortTest, MatchesStdSort) {
+    for (size_t n : {0, 1, 2, 23, 24, 25, 129, 1000, 100000}) {
+        for (const auto& input : int_inputs(n)) {
+            vector<int64_t> v = to_vector(input);
+            pdqsort(v);
+            std::vector<int64_t> expected(input);
+            std::sort(expected.begin(), expected.end());
+            ASSERT_EQ(to_std(v), expected) << n;
+        }
+    }
+}
+
+TEST(PdqsortTest, CustomComparatorAndStrings) {
+    std::mt19937 rng(5);
+    std::vector<std::string> input;
+    for (int i=0; i<5000; i++) input.push_back(std::to_string(rng() % 1000));
+    vector<std::string> v = to_vector(input);
+    pdqsort(v, std::greater<std::string>());
+    std::sort(input.begin(), input.end(), std::greater<std::string>());
+    EXPECT_EQ(to_std(v), input);
+}
+
+TEST(PdqsortTest, AdversarialComparatorStaysNLogN) {
+    // a comparator that counts calls: quadratic behaviour would need ~n^2/2
+    for (const auto& input : int_inputs(1 << 16)) {
+        vector<int64_t> v = to_vector(input);
+        size_t calls = 0;
+        pdqsort(v, [&](int64_t a, int64_t b) { calls++; return a < b; });
+        EXPECT_LT(calls, size_t(3) * (1 << 16) * 16);
+        EXPECT_TRUE(std::is_sorted(v.begin().ptr, v.end().ptr));
+    }
+}
+
+// McIlroy's "killer adversary for quicksort": values start out undecided
+// ("gas") and are frozen one at a time, always so as to make the current
+// pivot candidate lose - every partition comes out as unbalanced as possible
+struct antiqsort {
+    std::vector<int>& val;
+    int& candidate;
+    int& frozen;
+    size_t& calls;
+    int gas;
+
+    bool operator()(int x, int y) {
+        calls++;
+        if (val[x] == gas && val[y] == gas) val[x == candidate ? x : y] = frozen++;
+        if (val[x] == gas) candidate = x;
+        else if (val[y] == gas) candidate = y;
+        return val[x] < val[y];
+    }
+};
+
+TEST(PdqsortTest, HeapsortFallback) {
+    // only the switch to heapsort after log2(n) bad partitions keeps this n log n
+    const int n = 1 << 16;
+    std::vector<int> val(n, n);
+    int candidate = 0, frozen = 0;
+    size_t calls = 0;
+    vector<int> v(n);
+    for (int i=0; i<n; i++) v.push_back(i);
+    pdqsort(v, antiqsort{val, candidate, frozen, calls, n});
+    EXPECT_LT(calls, size_t(4) * n * 16);               // quadratic would be ~n^2/2
+    EXPECT_TRUE(std::is_sorted(v.begin().ptr, v.end().ptr,
+        [&](int x, int y) { return val[x] < val[y]; }));
+
+    // heap_sort on its own
+    std::vector<int> input(5000);
+    for (size_t i=0; i<input.size(); i++) input[i] = int((i * 7919) % 5000);
+    vector<int> w = to_vector(input);
+    int* first = &w[0];
+    std::greater<int> comp;
+    sort_detail::heap_sort(first, first + w.getSize(), comp);
+    EXPECT_TRUE(std::is_sorted(first, first + w.getSize(), comp));
+}
+
+TEST(RadixSortTest, IntegersMatchStdSort) {
+    for (size_t n : {0, 1, 63, 64, 65, 1000, 100000}) {
+        for (const auto& input : int_inputs(n)) {
+            vector<int64_t> v = to_vector(input);
+            radix_sort(v);
+            std::vector<int64_t> expected(input);
+            std::sort(expected.begin(), expected.end());
+            ASSERT_EQ(to_std(v), expected) << n;
+
+            std::vector<uint32_t> u32;
+            for (int64_t x : input) u32.push_back(uint32_t(x));
+            vector<uint32_t> w = to_vector(u32);
+            radix_sort(w);
+            std::sort(u32.begin(), u32.end());
+            ASSERT_EQ(to_std(w), u32) << n;
+        }
+    }
+}
+
+TEST(RadixSortTest, FloatsOrderNegativesAndInfinities) {
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    std::vector<double> input{0.0, -0.0, std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity(), 1e-300, -1e-300};
+    for (int i=0; i<10000; i++) input.push_back(dist(rng));
+    vector<double> v = to_vector(input);
+    radix_sort(v);
+    std::vector<double> got = to_std(v);
+    std::sort(input.begin(), input.end());
+    EXPECT_EQ(got, input);
+    EXPECT_EQ(got.front(), -std::numeric_limits<double>::infinity());
+    EXPECT_EQ(got.back(), std::numeric_limits<double>::infinity());
+
+    std::vector<float> fin;
+    for (int i=0; i<1000; i++) fin.push_back(float(dist(rng)));
+    vector<float> f = to_vector(fin);
+    radix_sort(f);
+    std::sort(fin.begin(), fin.end());
+    EXPECT_EQ(to_std(f), fin);
+}
+
+struct record {
+    uint32_t key;
+    std::string payload;            // non-trivial: exercises the move path
+};
+
+TEST(RadixSortTest, RecordsByKeyAreStable) {
+    std::mt19937 rng(13);
+    std::vector<record> input;
+    for (int i=0; i<20000; i++) input.push_back({uint32_t(rng() % 500), std::to_string(i)});
+
+    vector<record> v(input.size());
+    for (const record& r : input) v.push_back(r);
+    radix_sorter<record> sorter;
+    sorter.sort(v, [](const record& r) { return r.key; });
+
+    std::stable_sort(input.begin(), input.end(), [](const record& a, const record& b) { return a.key < b.key; });
+    for (size_t i=0; i<input.size(); i++) {
+        ASSERT_EQ(v[i].key, input[i].key);
+        ASSERT_EQ(v[i].payload, input[i].payload);     // equal keys keep input order
+    }
+
+    // the same sorter again; below 64 elements it uses insertion sort
+    vector<record> w(3);
+    w.push_back({3, "c"});
+    w.push_back({1, "a"});
+    w.push_back({2, "b"});
+    sorter.sort(w, [](const record& r) { return r.key; });
+    EXPECT_EQ(w[0].payload, "a");
+    EXPECT_EQ(w[2].payload, "c");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
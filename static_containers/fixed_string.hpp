@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+#include "../string/string.hpp"
+
+// String of exactly N chars stored inline (plus a terminator) - constexpr,
+// no heap, and usable as a non-type template parameter:
+//   template<fixed_string Name> struct counter { ... };
+//   counter<"requests"> c;
+// - a string literal deduces N (fixed_string s = "abc" is fixed_string<3>)
+// - operator+ concatenates into fixed_string<N + M> at compile time
+template<size_t N>
+struct fixed_string {
+    // public only so the type is structural - use the member functions
+    char chars[N + 1] = {};
+
+    constexpr fixed_string() = default;
+    constexpr fixed_string(const char (&s)[N + 1]) {
+        for (size_t i=0; i<N; i++) chars[i] = s[i];
+    }
+
+    static constexpr size_t size() { return N; }
+    static constexpr bool empty() { return N == 0; }
+    constexpr const char* c_str() const { return chars; }
+    constexpr std::string_view view() const { return std::string_view(chars, N); }
+    constexpr operator std::string_view() const { return view(); }
+
+    constexpr char operator[](size_t i) const { return chars[i]; }
+    constexpr char& operator[](size_t i) { return chars[i]; }
+    constexpr const char* begin() const { return chars; }
+    constexpr const char* end() const { return chars + N; }
+
+    constexpr size_t find(char c) const {
+        for (size_t i=0; i<N; i++) {
+            if (chars[i] == c) return i;
+        }
+        return npos;
+    }
+
+    // Heap string with the same contents
+    constexpr string to_string() const { return string(chars, N); }
+
+    template<size_t M>
+    constexpr bool operator==(const fixed_string<M>& other) const {
+        return view() == other.view();
+    }
+
+    template<size_t M>
+    constexpr fixed_string<N + M> operator+(const fixed_string<M>& other) const {
+        fixed_string<N + M> out;
+        for (size_t i=0; i<N; i++) out.chars[i] = chars[i];
+        for (size_t i=0; i<M; i++) out.chars[N + i] = other.chars[i];
+        return out;
+    }
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+};
+
+template<size_t M>
+fixed_string(const char (&)[M]) -> fixed_string<M - 1>;
+
+// Copy a (constexpr-built) string into a fixed_string of exactly N chars
+//   constexpr auto s = to_fixed_string<5>(make_name());
+template<size_t N>
+constexpr fixed_string<N> to_fixed_string(const string& s) {
+    if (s.getSize() != N) throw std::length_error("to_fixed_string: size mismatch");
+    fixed_string<N> out;
+    for (size_t i=0; i<N; i++) out.chars[i] = s[i];
+    return out;
+}
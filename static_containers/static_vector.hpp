@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include "../vector/vector.hpp"
+
+// Fixed-capacity vector with inline storage - no heap, fully constexpr
+// - usable as a non-type template parameter: the members are public and
+//   structural, so T must be structural too (scalars, arrays, such structs)
+// - unused slots are value-initialized, so two equal vectors compare and
+//   mangle the same as template arguments
+// - T must be default-constructible; push_back past N throws std::length_error
+//   (a compile error during constant evaluation)
+template<typename T, size_t N>
+struct static_vector {
+    // public only so the type is structural - use the member functions
+    T elems[N > 0 ? N : 1] = {};
+    size_t count = 0;
+
+    constexpr static_vector() = default;
+    constexpr static_vector(std::initializer_list<T> init) {
+        for (const T& v : init) push_back(v);
+    }
+
+    // Capacity
+    constexpr size_t size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+    static constexpr size_t capacity() { return N; }
+
+    // Element access
+    constexpr T& operator[](size_t i) { return elems[i]; }
+    constexpr const T& operator[](size_t i) const { return elems[i]; }
+    constexpr const T& at(size_t i) const {
+        if (i >= count) throw std::out_of_range("static_vector::at index out of range");
+        return elems[i];
+    }
+    constexpr T& front() { return elems[0]; }
+    constexpr const T& front() const { return elems[0]; }
+    constexpr T& back() { return elems[count - 1]; }
+    constexpr const T& back() const { return elems[count - 1]; }
+    constexpr T* data() { return elems; }
+    constexpr const T* data() const { return elems; }
+
+    constexpr T* begin() { return elems; }
+    constexpr T* end() { return elems + count; }
+    constexpr const T* begin() const { return elems; }
+    constexpr const T* end() const { return elems + count; }
+
+    // Modifiers
+    constexpr void push_back(const T& value) {
+        if (count == N) throw std::length_error("static_vector full");
+        elems[count++] = value;
+    }
+    constexpr void pop_back() {
+        if (count == 0) throw std::out_of_range("Empty static_vector");
+        elems[--count] = T();
+    }
+    constexpr void clear() {
+        while (count) elems[--count] = T();
+    }
+
+    constexpr bool contains(const T& value) const {
+        for (size_t i=0; i<count; i++) {
+            if (elems[i] == value) return true;
+        }
+        return false;
+    }
+
+    constexpr bool operator==(const static_vector& other) const {
+        if (count != other.count) return false;
+        for (size_t i=0; i<count; i++) {
+            if (!(elems[i] == other.elems[i])) return false;
+        }
+        return true;
+    }
+};
+
+// Copy a (constexpr-built) vector into static storage. vector's heap memory
+// cannot outlive constant evaluation, so compile-time tables are built in a
+// vector and returned as a static_vector:
+//   constexpr auto table = to_static_vector<256>(build_table());
+template<size_t N, typename T>
+constexpr static_vector<T, N> to_static_vector(const vector<T>& v) {
+    static_vector<T, N> out;
+    for (size_t i=0; i<v.getSize(); i++) out.push_back(v[i]);
+    return out;
+}
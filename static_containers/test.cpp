@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include "static_vector.hpp"
+#include "fixed_string.hpp"
+#include <cstdint>
+
+// vector and string in constant evaluation - the heap memory is freed before
+// the evaluation ends, so only the computed values escape
+constexpr int sum_of_squares(int n) {
+    vector<int> v;
+    for (int i=1; i<=n; i++) v.push_back(i * i);
+    vector<int> copy(v);
+    copy.pop();
+    int total = 0;
+    for (int x : copy) total += x;
+    return total;
+}
+static_assert(sum_of_squares(10) == 285);      // 1..9 squared, after pop
+
+constexpr string greeting() {
+    string s("hello");
+    s.push_back(',');
+    s.append(string(" world"));
+    s.append("!!!", 1);
+    return s;
+}
+static_assert(greeting().getSize() == 13);
+static_assert(greeting().find(string("world")) == 7);
+static_assert(greeting().substr(0, 5).compare(string("hello")) == 0);
+
+// CRC32C table built with a vector, baked into the binary as a static_vector
+constexpr vector<uint32_t> crc_table() {
+    vector<uint32_t> t(256);
+    for (uint32_t i=0; i<256; i++) {
+        uint32_t r = i;
+        for (int b=0; b<8; b++) r = (r >> 1) ^ (0x82F63B78u & (0u - (r & 1)));
+        t.push_back(r);
+    }
+    return t;
+}
+constexpr auto crc32c_table = to_static_vector<256>(crc_table());
+static_assert(crc32c_table.size() == 256 && crc32c_table[1] == 0xF26B8303u);
+
+// static_vector and fixed_string as non-type template parameters
+template<static_vector<int, 8> Values>
+constexpr int total() {
+    int t = 0;
+    for (int v : Values) t += v;
+    return t;
+}
+static_assert(total<static_vector<int, 8>{1, 2, 3}>() == 6);
+
+template<fixed_string Name>
+struct named_counter {
+    static constexpr std::string_view name() { return Name; }
+    int value = 0;
+};
+static_assert(named_counter<"requests">::name() == "requests");
+static_assert(std::is_same_v<named_counter<"a">, named_counter<fixed_string("a")>>);
+
+// keyword set baked into the binary (string_view is not structural, so this
+// one is a constexpr object rather than a template argument)
+constexpr static_vector<std::string_view, 16> keywords{"if", "else", "while", "return"};
+static_assert(keywords.contains("while") && !keywords.contains("whilst"));
+
+constexpr auto joined = fixed_string("flat") + fixed_string("_map");
+static_assert(joined.size() == 8 && joined == fixed_string("flat_map"));
+static_assert(joined.find('_') == 4);
+static_assert(to_fixed_string<greeting().getSize()>(greeting()) == fixed_string("hello, world!"));
+
+TEST(StaticVectorTest, RuntimeUse) {
+    static_vector<int, 4> v;
+    EXPECT_TRUE(v.empty());
+    v.push_back(1);
+    v.push_back(2);
+    v.push_back(3);
+    v.push_back(4);
+    EXPECT_THROW(v.push_back(5), std::length_error);
+    EXPECT_EQ(v.back(), 4);
+    v.pop_back();
+    EXPECT_EQ(v.size(), 3);
+    EXPECT_THROW(v.at(3), std::out_of_range);
+    EXPECT_TRUE(v == (static_vector<int, 4>{1, 2, 3}));
+    v.clear();
+    EXPECT_THROW(v.pop_back(), std::out_of_range);
+}
+
+TEST(StaticVectorTest, BakedTableMatchesRuntime) {
+    vector<uint32_t> runtime = crc_table();
+    ASSERT_EQ(runtime.getSize(), crc32c_table.size());
+    for (size_t i=0; i<256; i++) EXPECT_EQ(runtime[i], crc32c_table[i]);
+}
+
+TEST(FixedStringTest, RuntimeUse) {
+    fixed_string s = "abc";
+    s[0] = 'x';
+    EXPECT_STREQ(s.c_str(), "xbc");
+    EXPECT_EQ(s.view(), "xbc");
+    string heap = s.to_string();
+    EXPECT_STREQ(heap.c_str(), "xbc");
+    EXPECT_EQ(named_counter<"requests">::name(), "requests");
+    EXPECT_EQ(fixed_string("abc").find('z'), fixed_string<3>::npos);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -3,6 +3,10 @@
 #include <cstring>
 #include <utility>
 #include <stdexcept>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include "../alloc_tracker/alloc_tracker.hpp"
 
 class string {
     private:
@@ -10,16 +14,38 @@ class string {
         size_t size;
         size_t capacity;
 
-        void reallocate(size_t new_capacity) {
-            char* new_data = new char[new_capacity+1];
+        // n chars + terminator - routed through alloc_tracker (plain operator new unless ALLOC_TRACKING)
+        // during constant evaluation std::allocator is the only allocator allowed
+        static constexpr char* allocate(size_t n) {
+            if (std::is_constant_evaluated()) {
+                char* p = std::allocator<char>().allocate(n+1);
+                for (size_t i=0; i<=n; i++) std::construct_at(p+i);     // start the chars' lifetimes
+                return p;
+            }
+            return static_cast<char*>(alloc_tracker::allocate(alloc_kind::string, n+1));
+        }
+        static constexpr void deallocate(char* p, size_t n) noexcept {
+            if (std::is_constant_evaluated()) {
+                if (p) std::allocator<char>().deallocate(p, n+1);
+                return;
+            }
+            alloc_tracker::deallocate(alloc_kind::string, p, n+1);
+        }
+
+        // char_traits is constexpr and compiles to memcpy/strlen/memcmp at run time
+        using traits = std::char_traits<char>;
+
+        constexpr void reallocate(size_t new_capacity) {
+            char* new_data = allocate(new_capacity);
 
             // will lose data if new_capacity < size
             size_t copy_size = (size > new_capacity) ? new_capacity : size;
-            std::memcpy(new_data, data, copy_size);
+            traits::copy(new_data, data, copy_size);
+            if (copy_size && !std::is_constant_evaluated()) alloc_tracker::on_realloc_copy(alloc_kind::string, copy_size);
 
             new_data[copy_size] = '\0';
 
-            delete[] data;
+            deallocate(data, capacity);
             data = new_data;
             size = copy_size;
             capacity = new_capacity;
@@ -27,36 +53,43 @@ class string {
 
     public:
     // Constructors/Destructor
-    string() noexcept : data(new char[1]), size(0), capacity(0) {
+    constexpr string() noexcept : data(allocate(0)), size(0), capacity(0) {
         data[0] = '\0';
     }
 
     // Construct from c string
-    string(const char* s) {
-        size = std::strlen(s);
+    constexpr string(const char* s) {
+        size = traits::length(s);
         capacity = size;
-        data = new char[capacity+1];
-        std::memcpy(data, s, size+1);
+        data = allocate(capacity);
+        traits::copy(data, s, size+1);
+    }
+
+    // Construct from n chars (need not be null-terminated)
+    constexpr string(const char* s, size_t n) : size(n), capacity(n) {
+        data = allocate(capacity);
+        traits::copy(data, s, n);
+        data[n] = '\0';
     }
 
     // copy constructor
-    string(const string& other) 
+    constexpr string(const string& other) 
         : size(other.size), capacity(other.capacity) {
-        data = new char[capacity+1];
-        std::memcpy(data, other.data, size+1);
+        data = allocate(capacity);
+        traits::copy(data, other.data, size+1);
     }
 
     // move constructor
-    string(string&& other) noexcept 
+    constexpr string(string&& other) noexcept 
         : data(other.data), size(other.size), capacity(other.capacity) {
-        other.data = new char[1];
+        other.data = allocate(0);
         other.data[0] = '\0';
         other.size = 0;
         other.capacity = 0;
     }
 
-    ~string() {
-        delete[] data;
+    constexpr ~string() {
+        deallocate(data, capacity);
     }
 
     // Assignment (Copy/Move)
@@ -69,25 +102,25 @@ class string {
     // }
 
     // Copy Assignment
-    string& operator=(const string& other) {
+    constexpr string& operator=(const string& other) {
         if (this == &other) return *this;
 
-        delete[] data;
+        deallocate(data, capacity);
 
         size = other.size;
         capacity = other.capacity;
 
-        data = new char[capacity + 1];
-        std::memcpy(data, other.data, size + 1);
+        data = allocate(capacity);
+        traits::copy(data, other.data, size + 1);
 
         return *this;
     }
 
     // Move Assignment
-    string& operator=(string&& other) noexcept {
+    constexpr string& operator=(string&& other) noexcept {
         if (this == &other) return *this;
 
-        delete[] data;
+        deallocate(data, capacity);
 
         data = other.data;
         size = other.size;
@@ -101,41 +134,41 @@ class string {
     }
 
     // Element access
-    char& operator[](size_t index) { return data[index]; }
-    const char& operator[](size_t index) const { return data[index]; }
+    constexpr char& operator[](size_t index) { return data[index]; }
+    constexpr const char& operator[](size_t index) const { return data[index]; }
 
-    char& at(size_t index) {
+    constexpr char& at(size_t index) {
         if (index >= size) throw std::out_of_range("string::at out of range");
         return data[index];
     }
-    const char& at(size_t index) const {
+    constexpr const char& at(size_t index) const {
         if (index >= size) throw std::out_of_range("string::at out of range");
         return data[index];
     }
 
-    const char* c_str() const {
+    constexpr const char* c_str() const {
         return data ? data : "";
     }
 
     // Capacity
-    bool empty() const { return size==0; }
-    size_t getSize() const { return size ;}
-    size_t getCapacity() const { return capacity ;}
+    constexpr bool empty() const { return size==0; }
+    constexpr size_t getSize() const { return size ;}
+    constexpr size_t getCapacity() const { return capacity ;}
 
-    void reserve(size_t new_capacity) {
+    constexpr void reserve(size_t new_capacity) {
         if (new_capacity > capacity) {
             reallocate(new_capacity);
         }
     }
 
     // Modifiers
-    void swap(string& other) noexcept {
+    constexpr void swap(string& other) noexcept {
         std::swap(data,other.data);
         std::swap(size,other.size);
         std::swap(capacity,other.capacity);
     }
 
-    void push_back(char c) {
+    constexpr void push_back(char c) {
         if (size==capacity) {
             size_t new_capacity = (capacity==0) ? 1 : capacity*2;
             reallocate(new_capacity);
@@ -144,35 +177,48 @@ class string {
         data[size] = '\0';
     }
 
-    void pop_back() {
+    constexpr void pop_back() {
         if (size > 0) {
             size--;
             data[size] = '\0';
         }
     }
 
-    void append(const string& other) {
-        if (size + other.size > capacity) {
-            reserve(size + other.size);
+    constexpr void append(const string& other) {
+        append(other.data, other.size);
+    }
+
+    // s may point into this string: on growth the old buffer is freed only
+    // after both parts are copied out of it
+    constexpr void append(const char* s, size_t n) {
+        if (size + n > capacity) {
+            char* new_data = allocate(size + n);
+            traits::copy(new_data, data, size);
+            if (size && !std::is_constant_evaluated()) alloc_tracker::on_realloc_copy(alloc_kind::string, size);
+            traits::copy(new_data+size, s, n);
+            deallocate(data, capacity);
+            data = new_data;
+            capacity = size + n;
+        } else {
+            traits::copy(data+size, s, n);
         }
-        std::memcpy(data+size, other.data, other.size);
-        size += other.size;
+        size += n;
         data[size] = '\0';
     }
 
-    void clear() {
+    constexpr void clear() {
         size = 0;
         data[0] = '\0';
     }
 
-    void shrink_to_fit() {
+    constexpr void shrink_to_fit() {
         if (capacity > size) {
             reallocate(size);
         }
     }
 
     // Search
-    size_t find(const string& needle) const {
+    constexpr size_t find(const string& needle) const {
         if (needle.size == 0) return 0;
         if (needle.size > size) return npos;
 
@@ -189,7 +235,7 @@ class string {
         return npos;
     }
 
-    size_t find(char c) const {
+    constexpr size_t find(char c) const {
         for (size_t i=0; i<size; i++) {
             if (data[i] == c) return i;
         }
@@ -197,7 +243,7 @@ class string {
     }
 
     // Operations
-    string substr(size_t pos, size_t len) const {
+    constexpr string substr(size_t pos, size_t len) const {
         if (pos > size) throw std::out_of_range("string::substr out of range");
         if (pos + len > size) len = size - pos;
         string res;
@@ -208,10 +254,10 @@ class string {
         return res;
     }
 
-    int compare(const string& other) const {
+    constexpr int compare(const string& other) const {
         size_t min_len = (size < other.size) ? size : other.size;
-        // memcpy returns <0 if first diff byte of data < other.data, etc.
-        int cmp = std::memcmp(data, other.data, min_len);
+        // compare returns <0 if first diff byte of data < other.data, etc.
+        int cmp = traits::compare(data, other.data, min_len);
         if (cmp != 0) return cmp;
         if (size == other.size) return 0;
         return (size < other.size) ? -1 : 1;
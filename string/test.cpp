@@ -67,6 +67,27 @@ TEST(StringTest, Append) {
     EXPECT_STREQ(s1.c_str(), "foobar");
 }
 
+TEST(StringTest, PointerAndLength) {
+    const char buf[] = "hello world";
+    string s(buf, 5);                       // no terminator needed at buf[5]
+    EXPECT_EQ(s.getSize(), 5);
+    EXPECT_STREQ(s.c_str(), "hello");
+    s.append(buf + 5, 6);
+    EXPECT_STREQ(s.c_str(), "hello world");
+}
+
+TEST(StringTest, AppendFromItself) {
+    string s("abc");                        // capacity 3: both appends reallocate
+    s.append(s);
+    EXPECT_STREQ(s.c_str(), "abcabc");
+    s.append(s.c_str() + 1, 4);
+    EXPECT_STREQ(s.c_str(), "abcabcbcab");
+
+    s.reserve(100);                         // and without reallocating
+    s.append(s.c_str(), 3);
+    EXPECT_STREQ(s.c_str(), "abcabcbcababc");
+}
+
 TEST(StringTest, ShrinkToFit) {
     string s("hello");
     s.reserve(100);
@@ -0,0 +1,68 @@
+// parallel_for on the pool vs one std::thread per chunk, plus fork/join fib
+// g++ -std=c++20 -O2 -pthread bench.cpp -o bench && ./bench
+#include "thread_pool.hpp"
+#include "../vector/vector.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+template<typename F>
+double time_ms(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static long fib(thread_pool& pool, int n) {
+    if (n < 16) return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    long a = 0;
+    task_group group(pool);
+    group.run([&] { a = fib(pool, n - 1); });
+    long b = fib(pool, n - 2);
+    group.wait();
+    return a + b;
+}
+
+int main() {
+    const size_t n = 1 << 20;
+    const int rounds = 50;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    vector<double> v(n);
+    for (size_t i=0; i<n; i++) v.push_back(double(i));
+    auto work = [&](size_t i) { v[i] = std::sqrt(v[i] + 1.0); };
+
+    double raw = time_ms([&] {
+        for (int r=0; r<rounds; r++) {
+            std::vector<std::thread> ts;
+            size_t chunk = (n + threads - 1) / threads;
+            for (unsigned t=0; t<threads; t++) {
+                ts.emplace_back([&, t] {
+                    size_t end = std::min(n, (t + 1) * chunk);
+                    for (size_t i=t*chunk; i<end; i++) work(i);
+                });
+            }
+            for (auto& th : ts) th.join();
+        }
+    });
+
+    thread_pool pool(threads, true);
+    double pooled = time_ms([&] {
+        for (int r=0; r<rounds; r++) parallel_for(pool, 0, n, 4096, work);
+    });
+    std::printf("threads=%u  parallel_for x%d: std::thread per chunk %8.2f ms  pool %8.2f ms\n",
+        threads, rounds, raw, pooled);
+
+    long result = 0;
+    double fork_join = time_ms([&] { result = pool.submit([&] { return fib(pool, 32); }).get(); });
+    std::printf("fib(32)=%ld  task_group fork/join %8.2f ms\n", result, fork_join);
+
+    auto stats = pool.get_stats();
+    for (size_t i=0; i<stats.size(); i++) {
+        std::printf("worker %zu: executed=%zu steals=%zu idle=%.2f ms pinned=%d\n", i,
+            stats[i].executed, stats[i].steals, stats[i].idle.count() / 1e6, int(stats[i].pinned));
+    }
+}
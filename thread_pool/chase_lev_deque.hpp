@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli 2013)
+// - the owner thread pushes and pops at the bottom (LIFO, cache-warm)
+// - any thread steals from the top (FIFO, oldest = usually biggest work)
+// - grows by doubling; old arrays are kept until destruction since a
+//   concurrent thief may still be reading them
+// - T must be trivially copyable (task pointers); pop/steal return T{} when empty
+// seq_cst operations stand in for the paper's fences (same cost on x86,
+// and ThreadSanitizer can check them)
+template<typename T>
+class chase_lev_deque {
+private:
+    static_assert(std::is_trivially_copyable_v<T>, "chase_lev_deque holds trivially copyable values");
+
+    struct Array {
+        int64_t capacity;
+        int64_t mask;
+        std::atomic<T>* slots;
+
+        explicit Array(int64_t cap) : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+        ~Array() { delete[] slots; }
+
+        T get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T v) { slots[i & mask].store(v, std::memory_order_relaxed); }
+
+        Array* grow(int64_t bottom, int64_t top) const {
+            Array* bigger = new Array(capacity * 2);
+            for (int64_t i = top; i < bottom; i++) bigger->put(i, get(i));
+            return bigger;
+        }
+    };
+
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<Array*> array;
+    std::vector<Array*> retired;    // owner only
+
+public:
+    explicit chase_lev_deque(int64_t capacity = 256)
+        : top(0), bottom(0), array(new Array(capacity)) {}
+
+    ~chase_lev_deque() {
+        delete array.load(std::memory_order_relaxed);
+        for (Array* a : retired) delete a;
+    }
+
+    chase_lev_deque(const chase_lev_deque&) = delete;
+    chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+
+    // Owner only
+    void push(T v) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            retired.push_back(a);
+            a = a->grow(b, t);
+            array.store(a, std::memory_order_release);
+        }
+        a->put(b, v);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only
+    T pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_seq_cst);
+
+        if (t > b) {                        // empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return T{};
+        }
+        T v = a->get(b);
+        if (t == b) {                       // last element - race thieves for it
+            if (!top.compare_exchange_strong(t, t + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                v = T{};
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return v;
+    }
+
+    // Any thread
+    T steal() {
+        int64_t t = top.load(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) return T{};
+
+        Array* a = array.load(std::memory_order_acquire);
+        T v = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return T{};                     // lost the race, caller may retry elsewhere
+        }
+        return v;
+    }
+
+    bool empty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,182 @@
+#include "gtest/gtest.h"
+#include "thread_pool.hpp"
+#include "../vector/vector.hpp"
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+TEST(ChaseLevDequeTest, OwnerLifoThiefFifo) {
+    chase_lev_deque<int*> d(4);
+    int items[10];
+    for (int i=0; i<10; i++) d.push(&items[i]);     // grows past 4
+
+    EXPECT_EQ(d.pop(), &items[9]);
+    EXPECT_EQ(d.steal(), &items[0]);
+    EXPECT_EQ(d.steal(), &items[1]);
+    for (int i=8; i>=2; i--) EXPECT_EQ(d.pop(), &items[i]);
+    EXPECT_EQ(d.pop(), nullptr);
+    EXPECT_EQ(d.steal(), nullptr);
+    EXPECT_TRUE(d.empty());
+}
+
+TEST(ChaseLevDequeTest, EveryItemTakenOnce) {
+    constexpr int n = 20000;
+    chase_lev_deque<int*> d(8);
+    std::vector<int> items(n, 0);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t=0; t<3; t++) {
+        thieves.emplace_back([&] {
+            while (!done.load()) {
+                if (int* p = d.steal()) ++*p;
+            }
+        });
+    }
+    for (int i=0; i<n; i++) {
+        d.push(&items[i]);
+        if (i % 3 == 0) {
+            if (int* p = d.pop()) ++*p;
+        }
+    }
+    while (int* p = d.pop()) ++*p;
+    done = true;
+    for (auto& th : thieves) th.join();
+
+    for (int i=0; i<n; i++) ASSERT_EQ(items[i], 1) << i;
+}
+
+TEST(ThreadPoolTest, SubmitReturnsValue) {
+    thread_pool pool(4);
+    auto f = pool.submit([] { return 6 * 7; });
+    auto g = pool.submit([] {});
+    EXPECT_EQ(f.get(), 42);
+    g.get();
+    EXPECT_FALSE(f.valid());
+}
+
+TEST(ThreadPoolTest, SubmitPropagatesException) {
+    thread_pool pool(2);
+    auto f = pool.submit([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(f.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, NestedWaitDoesNotDeadlock) {
+    thread_pool pool(1);
+    // the only worker waits on a task queued behind it - it must run it itself
+    auto outer = pool.submit([&pool] {
+        auto inner = pool.submit([] { return 1; });
+        return inner.get() + 1;
+    });
+    EXPECT_EQ(outer.get(), 2);
+}
+
+static long fib(thread_pool& pool, int n) {
+    if (n < 12) return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    long a = 0, b = 0;
+    task_group group(pool);
+    group.run([&] { a = fib(pool, n - 1); });
+    b = fib(pool, n - 2);
+    group.wait();
+    return a + b;
+}
+
+TEST(ThreadPoolTest, TaskGroupForkJoin) {
+    thread_pool pool(4);
+    auto f = pool.submit([&pool] { return fib(pool, 24); });
+    EXPECT_EQ(f.get(), 46368);
+
+    size_t executed = 0;
+    for (auto& s : pool.get_stats()) executed += s.executed;
+    EXPECT_GT(executed, 1);
+}
+
+TEST(ThreadPoolTest, TaskGroupWaitHelps) {
+    thread_pool pool(1);
+    std::atomic<bool> started{false}, release{false};
+    auto blocker = pool.submit([&] {
+        started = true;
+        while (!release.load()) std::this_thread::yield();
+    });
+    while (!started.load()) std::this_thread::yield();
+
+    // the worker is stuck, so wait() has to run the children on this thread
+    std::atomic<int> ran{0};
+    task_group group(pool);
+    for (int i=0; i<100; i++) group.run([&] { ++ran; });
+    group.wait();
+    EXPECT_EQ(ran, 100);
+
+    release = true;
+    blocker.get();
+}
+
+TEST(ThreadPoolTest, TaskGroupRethrowsFirstException) {
+    thread_pool pool(2);
+    task_group group(pool);
+    std::atomic<int> ran{0};
+    for (int i=0; i<10; i++) {
+        group.run([&ran, i] {
+            ++ran;
+            if (i == 3) throw std::logic_error("child");
+        });
+    }
+    EXPECT_THROW(group.wait(), std::logic_error);
+    EXPECT_EQ(ran, 10);
+    group.wait();       // exception consumed
+}
+
+TEST(ThreadPoolTest, ParallelForOverVector) {
+    thread_pool pool(4);
+    vector<int> v(10000);
+    for (int i=0; i<10000; i++) v.push_back(i);
+
+    parallel_for(pool, 0, v.getSize(), 256, [&](size_t i) { v[i] *= 2; });
+    for (int i=0; i<10000; i++) ASSERT_EQ(v[i], 2 * i);
+}
+
+TEST(ThreadPoolTest, DestructorDrainsQueue) {
+    std::atomic<int> ran{0};
+    {
+        thread_pool pool(2);
+        for (int i=0; i<1000; i++) pool.submit([&] { ++ran; });
+    }
+    EXPECT_EQ(ran, 1000);
+}
+
+TEST(ThreadPoolTest, ExternalSubmitterOutlivesPool) {
+    // the submitting thread caches a record of the pool's node pool
+    std::atomic<int> phase{0};
+    auto pool = std::make_unique<thread_pool>(2);
+    std::thread submitter([&] {
+        EXPECT_EQ(pool->submit([] { return 1; }).get(), 1);
+        phase = 1;
+        while (phase != 2) std::this_thread::yield();
+    });
+    while (phase != 1) std::this_thread::yield();
+    pool.reset();
+    phase = 2;
+    submitter.join();
+}
+
+TEST(ThreadPoolTest, PinnedWorkersReportStats) {
+    thread_pool pool(2, true);
+    for (int i=0; i<100; i++) pool.submit([] {}).get();
+
+    auto stats = pool.get_stats();
+    ASSERT_EQ(stats.size(), 2);
+    size_t executed = 0;
+    for (auto& s : stats) {
+        executed += s.executed;
+#ifdef __linux__
+        EXPECT_TRUE(s.pinned);
+#endif
+        EXPECT_GE(s.idle.count(), 0);
+    }
+    EXPECT_EQ(executed, 100);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
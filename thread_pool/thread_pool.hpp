@@ -0,0 +1,407 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "chase_lev_deque.hpp"
+#include "../inplace_function/inplace_function.hpp"
+#include "../object_pool/object_pool.hpp"
+#include "../shared_ptr/intrusive_ptr.hpp"
+#include "../unique_ptr/unique_ptr.hpp"
+
+class thread_pool;
+
+// Shared state of a future - one allocation, counted intrusively
+template<typename T>
+struct future_state : intrusive_ref_counter<future_state<T>> {
+    std::atomic<bool> ready{false};
+    std::optional<std::conditional_t<std::is_void_v<T>, char, T>> value;
+    std::exception_ptr error;
+
+    template<typename F>
+    void run(F& fn) noexcept {
+        try {
+            if constexpr (std::is_void_v<T>) fn();
+            else value.emplace(fn());
+        } catch (...) {
+            error = std::current_exception();
+        }
+        ready.store(true, std::memory_order_release);
+        ready.notify_all();
+    }
+};
+
+// Result of thread_pool::submit
+// - a single pointer to the shared state (no mutex, no condition variable)
+// - get() on a worker thread runs other tasks while it waits instead of
+//   blocking the worker; other threads block on the ready flag
+template<typename T>
+class future {
+private:
+    intrusive_ptr<future_state<T>> state;
+    thread_pool* pool;
+
+public:
+    future() noexcept : pool(nullptr) {}
+    future(intrusive_ptr<future_state<T>> s, thread_pool* p) noexcept : state(std::move(s)), pool(p) {}
+
+    bool valid() const noexcept { return bool(state); }
+    bool is_ready() const noexcept { return state->ready.load(std::memory_order_acquire); }
+
+    void wait() const;
+
+    // Rethrows the task's exception; one-shot, like std::future
+    T get() {
+        wait();
+        auto s = std::move(state);
+        if (s->error) std::rethrow_exception(s->error);
+        if constexpr (!std::is_void_v<T>) return std::move(*s->value);
+    }
+};
+
+// Work-stealing thread pool
+// - each worker owns a Chase-Lev deque: tasks spawned from a worker go to
+//   its own bottom (LIFO, cache-warm), idle workers steal from other tops
+// - tasks from outside the pool go through a mutex-guarded injection queue
+// - tasks are inplace_functions in pooled nodes: no per-task heap allocation
+//   once the node pool is warm; callables over task_capacity bytes don't compile
+// - idle workers spin briefly, then sleep on a condition variable
+// - the destructor runs every queued task before joining
+class thread_pool {
+public:
+    static constexpr size_t task_capacity = 112;
+    using task = inplace_function<void(), task_capacity>;
+
+    struct worker_stats {
+        size_t executed;                    // tasks run by this worker
+        size_t steals;                      // tasks taken from another worker's deque
+        std::chrono::nanoseconds idle;      // time spent spinning or asleep
+        bool pinned;                        // affinity set successfully
+    };
+
+private:
+    struct task_node {
+        task fn;
+        template<typename F>
+        explicit task_node(F&& f) : fn(std::forward<F>(f)) {}
+    };
+
+    struct alignas(64) Worker {
+        chase_lev_deque<task_node*> deque;
+        std::thread thread;
+        uint64_t rng = 0;
+        std::atomic<size_t> executed{0};
+        std::atomic<size_t> steals{0};
+        std::atomic<int64_t> idle_ns{0};
+        std::atomic<bool> pinned{false};
+    };
+
+    struct context {
+        thread_pool* pool;
+        Worker* self;
+    };
+
+    static constexpr int spin_rounds = 64;
+
+    inline static thread_local context current{nullptr, nullptr};
+
+    object_pool<task_node> nodes;
+    unique_ptr<Worker[]> workers;
+    size_t worker_count;
+
+    std::mutex inject_mtx;
+    std::deque<task_node*> injected;
+
+    // tasks scheduled but not yet taken - incremented before the push, so a
+    // worker that sees zero under sleep_mtx can sleep without losing a wakeup
+    std::atomic<int64_t> queued{0};
+    std::atomic<size_t> sleepers{0};
+    std::mutex sleep_mtx;
+    std::condition_variable wake;
+    std::atomic<bool> stopping{false};
+
+    static void bump(std::atomic<size_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Worker* local_worker() const noexcept {
+        return current.pool == this ? current.self : nullptr;
+    }
+
+    void schedule(task_node* n) {
+        queued.fetch_add(1, std::memory_order_seq_cst);
+        if (Worker* w = local_worker()) {
+            w->deque.push(n);
+        } else {
+            std::lock_guard<std::mutex> lock(inject_mtx);
+            injected.push_back(n);
+        }
+        if (sleepers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(sleep_mtx);
+            wake.notify_one();
+        }
+    }
+
+    task_node* pop_injected() {
+        std::lock_guard<std::mutex> lock(inject_mtx);
+        if (injected.empty()) return nullptr;
+        task_node* n = injected.front();
+        injected.pop_front();
+        return n;
+    }
+
+    // one pass over the other workers, starting at a random victim
+    task_node* steal(Worker* self) {
+        uint64_t r;
+        if (self) {
+            self->rng ^= self->rng << 13;
+            self->rng ^= self->rng >> 7;
+            self->rng ^= self->rng << 17;
+            r = self->rng;
+        } else {
+            r = uint64_t(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        }
+        for (size_t i=0; i<worker_count; i++) {
+            Worker& victim = workers[(r + i) % worker_count];
+            if (&victim == self) continue;
+            if (task_node* n = victim.deque.steal()) {
+                if (self) bump(self->steals);
+                return n;
+            }
+        }
+        return nullptr;
+    }
+
+    // own deque, then the injection queue, then other workers
+    task_node* find_task(Worker* self) {
+        task_node* n = self ? self->deque.pop() : nullptr;
+        if (!n) n = pop_injected();
+        if (!n) n = steal(self);
+        if (n) queued.fetch_sub(1, std::memory_order_relaxed);
+        return n;
+    }
+
+    void run(task_node* n, Worker* self) {
+        object_pool<task_node>::handle h(n, {&nodes});
+        h->fn();
+        if (self) bump(self->executed);
+    }
+
+    // returns false once stopping and nothing is left to run
+    bool wait_for_work() {
+        for (int i=0; i<spin_rounds; i++) {
+            if (queued.load(std::memory_order_relaxed) > 0) return true;
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(sleep_mtx);
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        wake.wait(lock, [&] {
+            return queued.load(std::memory_order_seq_cst) > 0 || stopping.load(std::memory_order_relaxed);
+        });
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+        return queued.load(std::memory_order_relaxed) > 0 || !stopping.load(std::memory_order_relaxed);
+    }
+
+    // pin to the index-th CPU this process may run on
+    static bool pin_to_cpu(size_t index) {
+#ifdef __linux__
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return false;
+        int count = CPU_COUNT(&allowed);
+        if (count == 0) return false;
+        int target = int(index % size_t(count));
+        for (int cpu=0; cpu<CPU_SETSIZE; cpu++) {
+            if (!CPU_ISSET(cpu, &allowed) || target-- > 0) continue;
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+        }
+        return false;
+#else
+        (void)index;
+        return false;
+#endif
+    }
+
+    void worker_loop(size_t index, bool pin) {
+        Worker& w = workers[index];
+        current = {this, &w};
+        if (pin) w.pinned.store(pin_to_cpu(index), std::memory_order_relaxed);
+
+        for (;;) {
+            if (task_node* n = find_task(&w)) {
+                run(n, &w);
+                continue;
+            }
+            auto idle_start = std::chrono::steady_clock::now();
+            bool more = wait_for_work();
+            auto idle = std::chrono::steady_clock::now() - idle_start;
+            w.idle_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(idle).count(),
+                                std::memory_order_relaxed);
+            if (!more) break;
+        }
+        current = {nullptr, nullptr};
+    }
+
+    template<typename F>
+    void spawn(F&& f) {
+        schedule(nodes.acquire(std::forward<F>(f)).release());
+    }
+
+    friend class task_group;
+
+public:
+    // Constructor - pin_threads binds worker i to the i-th allowed CPU (mod count)
+    explicit thread_pool(size_t threads = std::thread::hardware_concurrency(), bool pin_threads = false)
+        : workers(make_unique<Worker[]>(threads ? threads : 1)), worker_count(threads ? threads : 1) {
+        for (size_t i=0; i<worker_count; i++) {
+            workers[i].rng = 0x9E3779B97F4A7C15ull * (i + 1);
+        }
+        for (size_t i=0; i<worker_count; i++) {
+            workers[i].thread = std::thread([this, i, pin_threads] { worker_loop(i, pin_threads); });
+        }
+    }
+
+    // Destructor - drains queued tasks, then joins
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mtx);
+            stopping.store(true, std::memory_order_relaxed);
+        }
+        wake.notify_all();
+        for (size_t i=0; i<worker_count; i++) workers[i].thread.join();
+    }
+
+    // Delete Copy operations - workers point back at the pool
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Submit - run f() on the pool, result or exception through the future
+    template<typename F, typename R = std::invoke_result_t<std::decay_t<F>&>>
+    future<R> submit(F&& f) {
+        auto state = make_intrusive<future_state<R>>();
+        spawn([state, fn = std::forward<F>(f)]() mutable {
+            state->run(fn);
+        });
+        return future<R>(std::move(state), this);
+    }
+
+    // Run queued tasks on the calling thread until done() holds
+    template<typename Done>
+    void help_until(Done done) {
+        Worker* self = local_worker();
+        while (!done()) {
+            if (task_node* n = find_task(self)) run(n, self);
+            else std::this_thread::yield();
+        }
+    }
+
+    // Observers
+    size_t size() const noexcept { return worker_count; }
+    bool on_worker_thread() const noexcept { return local_worker() != nullptr; }
+
+    std::vector<worker_stats> get_stats() const {
+        std::vector<worker_stats> out;
+        out.reserve(worker_count);
+        for (size_t i=0; i<worker_count; i++) {
+            const Worker& w = workers[i];
+            out.push_back({w.executed.load(std::memory_order_relaxed),
+                           w.steals.load(std::memory_order_relaxed),
+                           std::chrono::nanoseconds(w.idle_ns.load(std::memory_order_relaxed)),
+                           w.pinned.load(std::memory_order_relaxed)});
+        }
+        return out;
+    }
+};
+
+template<typename T>
+void future<T>::wait() const {
+    if (pool && pool->on_worker_thread()) {
+        pool->help_until([this] { return is_ready(); });
+        return;
+    }
+    while (!state->ready.load(std::memory_order_acquire)) {
+        state->ready.wait(false, std::memory_order_acquire);
+    }
+}
+
+// Fork/join scope
+// - run() spawns a child task; wait() runs pending tasks on the calling
+//   thread until every child has finished, then rethrows the first exception
+// - the tasks wait() helps with can be any pool task, not only this group's
+// - the destructor waits too (exceptions dropped), so children never
+//   outlive the references they captured
+class task_group {
+private:
+    thread_pool& pool;
+    std::atomic<size_t> pending{0};
+    std::mutex error_mtx;
+    std::exception_ptr error;
+
+public:
+    explicit task_group(thread_pool& p) noexcept : pool(p) {}
+
+    ~task_group() {
+        pool.help_until([this] { return pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    template<typename F>
+    void run(F&& f) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        pool.spawn([this, fn = std::forward<F>(f)]() mutable {
+            {
+                // destroy the callable before signalling, the group may be gone right after
+                auto local = std::move(fn);
+                try {
+                    local();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mtx);
+                    if (!error) error = std::current_exception();
+                }
+            }
+            pending.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    void wait() {
+        pool.help_until([this] { return pending.load(std::memory_order_acquire) == 0; });
+        if (error) std::rethrow_exception(std::exchange(error, nullptr));
+    }
+};
+
+// Recursive halving so thieves take big ranges and owners keep small ones
+template<typename F>
+void parallel_for_split(task_group& group, size_t begin, size_t end, size_t grain, F& f) {
+    while (end - begin > grain) {
+        size_t mid = begin + (end - begin) / 2;
+        group.run([&group, mid, end, grain, &f] { parallel_for_split(group, mid, end, grain, f); });
+        end = mid;
+    }
+    for (size_t i=begin; i<end; i++) f(i);
+}
+
+// parallel_for - f(i) for i in [begin, end), leaves of at most grain indices
+template<typename F>
+void parallel_for(thread_pool& pool, size_t begin, size_t end, size_t grain, F&& f) {
+    if (begin >= end) return;
+    task_group group(pool);
+    parallel_for_split(group, begin, end, grain ? grain : 1, f);
+    group.wait();
+}
@@ -53,6 +53,99 @@ TEST_F(UniquePtrTest, Swap) {
     EXPECT_EQ(*f, 1);
 }
 
+// Test operator-> returns a pointer
+TEST_F(UniquePtrTest, ArrowOperator) {
+    struct Point { int x, y; };
+    unique_ptr<Point> p(new Point{1, 2});
+    EXPECT_EQ(p->y, 2);
+}
+
+// Test stateless deleter adds no size (empty base optimization)
+struct FreeCounter {
+    static int calls;
+    void operator()(int* p) const { ++calls; delete p; }
+};
+int FreeCounter::calls = 0;
+
+TEST_F(UniquePtrTest, StatelessDeleterIsFree) {
+    static_assert(sizeof(unique_ptr<int>) == sizeof(int*));
+    static_assert(sizeof(unique_ptr<int, FreeCounter>) == sizeof(int*));
+    static_assert(sizeof(unique_ptr<int[]>) == sizeof(int*));
+
+    FreeCounter::calls = 0;
+    {
+        unique_ptr<int, FreeCounter> a(new int(1));
+        unique_ptr<int, FreeCounter> b(std::move(a));
+        b.reset(new int(2));
+        EXPECT_EQ(FreeCounter::calls, 1);
+    }
+    EXPECT_EQ(FreeCounter::calls, 2);
+}
+
+// Test stateful deleter (e.g. returns memory to an arena)
+TEST_F(UniquePtrTest, StatefulDeleter) {
+    int slots[2] = {0, 0};
+    int returned = 0;
+    auto give_back = [&returned](int*) { ++returned; };
+    {
+        unique_ptr<int, decltype(give_back)> p(&slots[0], give_back);
+        EXPECT_EQ(p.get(), &slots[0]);
+    }
+    EXPECT_EQ(returned, 1);
+}
+
+// Test that a function pointer deleter starts null, not indeterminate
+static int freed_by_fn = 0;
+static void count_free(int*) { ++freed_by_fn; }
+
+TEST_F(UniquePtrTest, FunctionPointerDeleter) {
+    unique_ptr<int, void(*)(int*)> empty;
+    EXPECT_EQ(empty.get(), nullptr);
+    EXPECT_EQ(empty.get_deleter(), nullptr);
+
+    int slot = 0;
+    freed_by_fn = 0;
+    {
+        unique_ptr<int, void(*)(int*)> p(&slot, &count_free);
+        EXPECT_EQ(p.get_deleter(), &count_free);
+    }
+    EXPECT_EQ(freed_by_fn, 1);
+}
+
+// Test converting move from derived to base
+TEST_F(UniquePtrTest, ConvertingMove) {
+    struct Base { virtual ~Base() = default; virtual int id() const { return 0; } };
+    struct Derived : Base { int id() const override { return 1; } };
+    unique_ptr<Base> b = make_unique<Derived>();
+    EXPECT_EQ(b->id(), 1);
+}
+
+// Test array specialization
+TEST_F(UniquePtrTest, ArrayForm) {
+    unique_ptr<int[]> arr = make_unique<int[]>(4);
+    for (int i=0; i<4; i++) EXPECT_EQ(arr[i], 0);   // value-initialized
+    arr[2] = 7;
+    EXPECT_EQ(arr.get()[2], 7);
+
+    unique_ptr<int[]> moved(std::move(arr));
+    EXPECT_FALSE(arr);
+    EXPECT_EQ(moved[2], 7);
+}
+
+// Test make_unique / make_unique_for_overwrite
+TEST_F(UniquePtrTest, MakeUnique) {
+    auto p = make_unique<std::pair<int, int>>(3, 4);
+    EXPECT_EQ(p->second, 4);
+
+    auto buf = make_unique_for_overwrite<char[]>(1 << 16);
+    buf[0] = 'x';
+    EXPECT_EQ(buf[0], 'x');
+
+    auto one = make_unique_for_overwrite<int>();
+    *one = 5;
+    EXPECT_EQ(*one, 5);
+}
+
 // main function to run all tests
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -1,56 +1,172 @@
+#pragma once
 #include <utility>
 #include <cstddef>
+#include <type_traits>
 
+// Default deleters - delete for objects, delete[] for arrays
 template<typename T>
-class unique_ptr {
+struct default_delete {
+    default_delete() noexcept = default;
+    // allow unique_ptr<Derived> -> unique_ptr<Base>
+    template<typename U>
+    default_delete(const default_delete<U>&) noexcept {}
+
+    void operator()(T* p) const noexcept { delete p; }
+};
+
+template<typename T>
+struct default_delete<T[]> {
+    void operator()(T* p) const noexcept { delete[] p; }
+};
+
+// Empty base optimization - a stateless deleter is a base class and takes no space,
+// so unique_ptr<T> stays the size of one pointer; stateful/final deleters are a member
+template<typename D, bool = std::is_empty_v<D> && !std::is_final_v<D>>
+struct deleter_storage : private D {
+    deleter_storage() = default;
+    deleter_storage(D d) : D(std::move(d)) {}
+    D& get_deleter() noexcept { return *this; }
+    const D& get_deleter() const noexcept { return *this; }
+};
+
+template<typename D>
+struct deleter_storage<D, false> {
+    D deleter{};            // value-initialized: a function pointer deleter starts null
+    deleter_storage() = default;
+    deleter_storage(D d) : deleter(std::move(d)) {}
+    D& get_deleter() noexcept { return deleter; }
+    const D& get_deleter() const noexcept { return deleter; }
+};
+
+template<typename T, typename D = default_delete<T>>
+class unique_ptr : private deleter_storage<D> {
 private:
     T* ptr;
+
+    template<typename U, typename E> friend class unique_ptr;
+
 public:
+    using deleter_storage<D>::get_deleter;
+
     // Default Constructor
     unique_ptr() noexcept
         : ptr(nullptr) {};
 
-    // Construct from raw pointer 
+    // Construct from raw pointer
     explicit unique_ptr(T* p) noexcept
-        : ptr(p) {};
+        : ptr(p) {
+        static_assert(!std::is_pointer_v<D>, "unique_ptr: pass the function pointer deleter along with the pointer");
+    };
+
+    // Raw pointer + deleter (pool return, arena free, munmap...)
+    unique_ptr(T* p, D d) noexcept
+        : deleter_storage<D>(std::move(d)), ptr(p) {};
 
     // Destructor
     ~unique_ptr() {
-        delete(ptr);
+        if (ptr) get_deleter()(ptr);
     }
 
     // Delete Copy operations - we allow only one unique ptr per object
     unique_ptr(const unique_ptr&) = delete;
     unique_ptr& operator=(const unique_ptr&) = delete;
 
-    // Move Constructor 
-    unique_ptr(unique_ptr&& other) noexcept {
-        ptr = other.ptr;
+    // Move Constructor
+    unique_ptr(unique_ptr&& other) noexcept
+        : deleter_storage<D>(std::move(other.get_deleter())), ptr(other.ptr) {
         other.ptr = nullptr;
     }
 
+    // Converting Move Constructor - unique_ptr<Derived> -> unique_ptr<Base>
+    template<typename U, typename E>
+        requires std::is_convertible_v<U*, T*> && std::is_convertible_v<E, D>
+    unique_ptr(unique_ptr<U, E>&& other) noexcept
+        : deleter_storage<D>(std::move(other.get_deleter())), ptr(other.release()) {}
+
     // Move Assignment
     unique_ptr& operator=(unique_ptr&& other) noexcept {
         if (this != &other) {
-            delete ptr;
-            ptr = other.ptr;
-            other.ptr = nullptr;
+            reset(other.release());
+            get_deleter() = std::move(other.get_deleter());
         }
         return *this;
     }
 
     // Modifiers
+    // swap in the new pointer first, so a deleter that touches *this sees a valid state
     void reset(T* new_ptr = nullptr) noexcept {
-        delete ptr;
+        T* old = ptr;
         ptr = new_ptr;
+        if (old) get_deleter()(old);
     }
     void swap(unique_ptr& other) noexcept {
         std::swap(ptr, other.ptr);
+        std::swap(get_deleter(), other.get_deleter());
     }
 
     // Observers
     T& operator*() const noexcept { return *ptr; }
-    T& operator->() const noexcept { return *ptr; }
+    T* operator->() const noexcept { return ptr; }
+    T* get() const noexcept { return ptr; }
+    T* release() noexcept {
+        T* temp = ptr;
+        ptr = nullptr;
+        return temp;
+    }
+    explicit operator bool() const noexcept {
+        return ptr!=nullptr;
+    }
+};
+
+// Array form - delete[] by default, indexing instead of * and ->
+template<typename T, typename D>
+class unique_ptr<T[], D> : private deleter_storage<D> {
+private:
+    T* ptr;
+
+public:
+    using deleter_storage<D>::get_deleter;
+
+    // Constructors/Destructor
+    unique_ptr() noexcept : ptr(nullptr) {}
+    explicit unique_ptr(T* p) noexcept : ptr(p) {}
+    unique_ptr(T* p, D d) noexcept : deleter_storage<D>(std::move(d)), ptr(p) {}
+
+    ~unique_ptr() {
+        if (ptr) get_deleter()(ptr);
+    }
+
+    // Delete Copy operations
+    unique_ptr(const unique_ptr&) = delete;
+    unique_ptr& operator=(const unique_ptr&) = delete;
+
+    // Move Constructor/Assignment
+    unique_ptr(unique_ptr&& other) noexcept
+        : deleter_storage<D>(std::move(other.get_deleter())), ptr(other.ptr) {
+        other.ptr = nullptr;
+    }
+
+    unique_ptr& operator=(unique_ptr&& other) noexcept {
+        if (this != &other) {
+            reset(other.release());
+            get_deleter() = std::move(other.get_deleter());
+        }
+        return *this;
+    }
+
+    // Modifiers
+    void reset(T* new_ptr = nullptr) noexcept {
+        T* old = ptr;
+        ptr = new_ptr;
+        if (old) get_deleter()(old);
+    }
+    void swap(unique_ptr& other) noexcept {
+        std::swap(ptr, other.ptr);
+        std::swap(get_deleter(), other.get_deleter());
+    }
+
+    // Observers
+    T& operator[](size_t i) const noexcept { return ptr[i]; }
     T* get() const noexcept { return ptr; }
     T* release() noexcept {
         T* temp = ptr;
@@ -60,4 +176,32 @@ public:
     explicit operator bool() const noexcept {
         return ptr!=nullptr;
     }
-};
\ No newline at end of file
+};
+
+// make_unique<T>(args...) - forwards args to T's constructor
+template<typename T, typename... Args>
+    requires (!std::is_array_v<T>)
+unique_ptr<T> make_unique(Args&&... args) {
+    return unique_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+// make_unique<T[]>(n) - n value-initialized elements (zeroed for scalars)
+template<typename T>
+    requires std::is_unbounded_array_v<T>
+unique_ptr<T> make_unique(size_t n) {
+    return unique_ptr<T>(new std::remove_extent_t<T>[n]());
+}
+
+// make_unique_for_overwrite - default-initialized: scalars and trivial types
+// are left uninitialized, so large I/O buffers skip the memset
+template<typename T>
+    requires (!std::is_array_v<T>)
+unique_ptr<T> make_unique_for_overwrite() {
+    return unique_ptr<T>(new T);
+}
+
+template<typename T>
+    requires std::is_unbounded_array_v<T>
+unique_ptr<T> make_unique_for_overwrite(size_t n) {
+    return unique_ptr<T>(new std::remove_extent_t<T>[n]);
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "vector.hpp"
+#include <string>
 
 class VectorTest : public ::testing::Test {};
 
@@ -29,6 +30,18 @@ TEST_F(VectorTest, PushBackMove) {
     EXPECT_EQ(v1[0], 30);
 }
 
+// Test push_back of an element of the same vector while it grows
+TEST_F(VectorTest, PushBackOwnElement) {
+    vector<std::string> v;
+    v.push_back(std::string(32, 'a'));
+    v.push_back(std::string(32, 'b'));
+    v.push_back(v[0]);                          // full: reallocates
+    v.push_back(std::move(v[1]));               // full again
+    EXPECT_EQ(v.getSize(), 4);
+    EXPECT_EQ(v[2], std::string(32, 'a'));
+    EXPECT_EQ(v[3], std::string(32, 'b'));
+}
+
 // Test pop
 TEST_F(VectorTest, Pop) {
     vector<int> v1;
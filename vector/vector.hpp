@@ -1,7 +1,12 @@
+#pragma once
 #include <iostream>
 #include <utility>
 #include <stdexcept>
 #include <new>
+#include <cstring>
+#include <type_traits>
+#include <memory>
+#include "../alloc_tracker/alloc_tracker.hpp"
 
 template<typename T>
 class vector {
@@ -10,20 +15,41 @@ private:
 	size_t size;
 	size_t capacity;
 
-	void reallocate(size_t new_capacity) {
-		// allocate raw memory
-		T* new_data = static_cast<T*>(operator new(new_capacity*sizeof(T)));
+	// raw storage - routed through alloc_tracker (plain operator new unless ALLOC_TRACKING)
+	// during constant evaluation std::allocator is the only allocator allowed
+	static constexpr T* allocate(size_t n) {
+		if (std::is_constant_evaluated()) return std::allocator<T>().allocate(n);
+		return static_cast<T*>(alloc_tracker::allocate(alloc_kind::vector, n*sizeof(T), alignof(T)));
+	}
+	static constexpr void deallocate(T* p, size_t n) noexcept {
+		if (std::is_constant_evaluated()) {
+			if (p) std::allocator<T>().deallocate(p, n);
+			return;
+		}
+		alloc_tracker::deallocate(alloc_kind::vector, p, n*sizeof(T), alignof(T));
+	}
 
-		for (size_t i=0; i<size; i++) {
-			// move construct existing elements
-			// call T's move constructor to steal resource from old object
-			new (new_data+i) T(std::move(data[i]));
-			// destroy old object
-			data[i].~T();
+	constexpr void reallocate(size_t new_capacity) {
+		// allocate raw memory
+		T* new_data = allocate(new_capacity);
+		bool runtime = !std::is_constant_evaluated();
+		if (size && runtime) alloc_tracker::on_realloc_copy(alloc_kind::vector, size*sizeof(T));
+
+		if (runtime && std::is_trivially_copyable_v<T>) {
+			// relocation fast path - one memcpy, no per-element move/destroy
+			if (size) std::memcpy(static_cast<void*>(new_data), data, size*sizeof(T));
+		} else {
+			for (size_t i=0; i<size; i++) {
+				// move construct existing elements
+				// call T's move constructor to steal resource from old object
+				std::construct_at(new_data+i, std::move(data[i]));
+				// destroy old object
+				std::destroy_at(data+i);
+			}
 		}
 
 		// free old memory
-		operator delete(data);
+		deallocate(data, capacity);
 		data = new_data;
 		capacity = new_capacity;
 	}
@@ -32,37 +58,37 @@ public:
 	// Iterator - pointer wrapper to support iterator for-loop 
 	struct iterator {
         T* ptr;
-        iterator(T* p) : ptr(p) {}
-        T& operator*() { return *ptr; }
-        iterator& operator++() { ++ptr; return *this; }
-        iterator& operator--() { --ptr; return *this; }
-        bool operator!=(const iterator& other) const { return ptr != other.ptr; }
+        constexpr iterator(T* p) : ptr(p) {}
+        constexpr T& operator*() { return *ptr; }
+        constexpr iterator& operator++() { ++ptr; return *this; }
+        constexpr iterator& operator--() { --ptr; return *this; }
+        constexpr bool operator!=(const iterator& other) const { return ptr != other.ptr; }
     };
 
-	iterator begin() { return iterator(data); }
-    iterator end() { return iterator(data + size); }
+	constexpr iterator begin() { return iterator(data); }
+    constexpr iterator end() { return iterator(data + size); }
 
 	// 1) Constructors
 	// Default Constructor
-	vector() : data(nullptr), size(0), capacity(0) {}
+	constexpr vector() : data(nullptr), size(0), capacity(0) {}
 
 	// Constructor
-	vector(size_t n) : size(0), capacity(n) {
-		data = static_cast<T*>(operator new(capacity*sizeof(T)));
+	constexpr vector(size_t n) : size(0), capacity(n) {
+		data = allocate(capacity);
 	}
 
 	// Copy Constructor
-	vector(const vector& other) {
+	constexpr vector(const vector& other) {
 		size = other.size;
 		capacity = other.capacity;
-		data = static_cast<T*>(operator new(capacity*sizeof(T)));
+		data = allocate(capacity);
 		for (size_t i=0; i<size; i++) {
-			new (data+i) T(other.data[i]);
+			std::construct_at(data+i, other.data[i]);
 		}
 	}
 
 	// Move Constructor
-	vector(vector&& other) noexcept {
+	constexpr vector(vector&& other) noexcept {
 		data = other.data;
 		size = other.size;
 		capacity = other.capacity;
@@ -74,35 +100,35 @@ public:
 	
 	// 2) Assignments
 	// Copy assignment
-	vector& operator=(const vector& other) {
+	constexpr vector& operator=(const vector& other) {
 		if (this != &other) {
 			// destroy and free
 			for (size_t i=0; i<size; i++) {
-				data[i].~T();
+				std::destroy_at(data+i);
 			}
-			operator delete(data);
+			deallocate(data, capacity);
 
 			// allocate new
 			size = other.size;
 			capacity = other.capacity;
-			data = static_cast<T*>(operator new(capacity*sizeof(T)));
+			data = allocate(capacity);
 
 			//copy elements
 			for (size_t i=0; i<size; i++) {
-				new (data+i) T(other.data[i]);
+				std::construct_at(data+i, other.data[i]);
 			}
 		}
 		return *this;
 	}
 
 	// Move Assignment
-	vector& operator=(vector&& other) noexcept {
+	constexpr vector& operator=(vector&& other) noexcept {
 		if (this != &other) {
 			// destroy and free
 			for (size_t i=0; i<size; i++) {
-				data[i].~T();
+				std::destroy_at(data+i);
 			}
-			operator delete(data);
+			deallocate(data, capacity);
 
 			// steal resources
 			data = other.data;
@@ -117,43 +143,51 @@ public:
 	}
 
 	// 3) Destructor
-	~vector() {
+	constexpr ~vector() {
 		for (size_t i=0; i<size; i++) {
-			data[i].~T();
+			std::destroy_at(data+i);
 		}
-		operator delete(data);
+		deallocate(data, capacity);
 	}
 
 	// 4) Functions
 	// Insert
-	void push_back(const T& value) {
+	// value may be one of our elements (v.push_back(v[0])): when growing,
+	// take it out before reallocate() frees the old buffer
+	constexpr void push_back(const T& value) {
 		if (size == capacity) {
-			reallocate(capacity == 0 ? 1 : capacity * 2);
+			T copy(value);
+			push_back(std::move(copy));
+			return;
 		}
-		new (data+size) T(value);
+		std::construct_at(data+size, value);
 		size++;
 	}
 
-	void push_back(T&& value) {
+	constexpr void push_back(T&& value) {
 		if (size == capacity) {
+			T moved(std::move(value));
 			reallocate(capacity == 0 ? 1 : capacity * 2);
+			std::construct_at(data+size, std::move(moved));
+			size++;
+			return;
 		}
-		new (data+size) T(std::move(value));
+		std::construct_at(data+size, std::move(value));
 		size++;
 	}
 
 	// Delete
-	void pop() {
+	constexpr void pop() {
 		if (size == 0) throw std::out_of_range("Empty vector");
 		size--;
-		data[size].~T();
+		std::destroy_at(data+size);
 	}
 
 	// Access
-	T& operator[](size_t i) {return data[i];}
-	const T& operator[](size_t i) const {return data[i];}
+	constexpr T& operator[](size_t i) {return data[i];}
+	constexpr const T& operator[](size_t i) const {return data[i];}
 	
 	// Size/Capacity
-	size_t getSize() { return size; }
-	size_t getCapacity() { return capacity; }
+	constexpr size_t getSize() const { return size; }
+	constexpr size_t getCapacity() const { return capacity; }
 };